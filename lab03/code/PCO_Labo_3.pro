@@ -18,9 +18,21 @@ TEMPLATE = app
 LIBS += -lpcosynchro
 
 SOURCES += main.cpp \
-    machine.cpp
+    accountstore.cpp \
+    asynclogger.cpp \
+    fleet.cpp \
+    inventory.cpp \
+    machine.cpp \
+    scriptedmachine.cpp
 
 HEADERS  += \
+    accountstore.h \
+    asynclogger.h \
+    changemaker.h \
+    fleet.h \
+    inventory.h \
     machine.h \
     machinemanager.h \
-    machineinterface.h
+    machineinterface.h \
+    scriptedmachine.h \
+    spscring.h
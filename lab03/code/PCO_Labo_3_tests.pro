@@ -0,0 +1,31 @@
+CONFIG += c++17
+CONFIG += console
+CONFIG -= app_bundle
+QT -= gui qt
+
+unix {
+    LIBS += -lpthread
+}
+
+LIBS += -lgtest
+LIBS += -lpcosynchro
+
+INCLUDEPATH += . test
+SOURCES += \
+    accountstore.cpp \
+    asynclogger.cpp \
+    fleet.cpp \
+    inventory.cpp \
+    scriptedmachine.cpp \
+    test/main.cpp
+
+HEADERS += \
+    accountstore.h \
+    asynclogger.h \
+    changemaker.h \
+    fleet.h \
+    inventory.h \
+    machinemanager.h \
+    machineinterface.h \
+    scriptedmachine.h \
+    spscring.h
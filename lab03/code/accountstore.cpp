@@ -0,0 +1,192 @@
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <string.h>
+#include <unistd.h>
+
+#include "accountstore.h"
+
+/** Taille initiale de la table, une puissance de deux */
+static constexpr size_t INITIAL_SLOTS = 1024;
+
+// Les cases sont initialisées à zéro, donc vides
+AccountStore::AccountStore() : slots(INITIAL_SLOTS)
+{
+}
+
+uint32_t AccountStore::hashId(const char *id)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (; *id != '\0'; id++) {
+        hash ^= (unsigned char)*id;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+AccountStore::Slot &AccountStore::lookup(const char *id, uint32_t hash)
+{
+    size_t mask = slots.size() - 1;
+    // Sondage linéaire, la table n'étant jamais pleine
+    for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+        Slot &slot = slots[i];
+        if (slot.index == 0 || (slot.hash == hash && strcmp(slot.key, id) == 0))
+            return slot;
+    }
+}
+
+void AccountStore::grow()
+{
+    std::vector<Slot> old(slots.size() * 2);
+    old.swap(slots);
+    for (Slot &slot : old)
+        if (slot.index != 0)
+            lookup(slot.key, slot.hash) = slot;
+}
+
+void AccountStore::lockRead()
+{
+    tableMutex.lock();
+    while (writing || nbWritersWaiting > 0)
+        tableCond.wait(&tableMutex);
+    nbReaders++;
+    tableMutex.unlock();
+}
+
+void AccountStore::unlockRead()
+{
+    tableMutex.lock();
+    if (--nbReaders == 0)
+        tableCond.notifyAll();
+    tableMutex.unlock();
+}
+
+void AccountStore::lockWrite()
+{
+    tableMutex.lock();
+    nbWritersWaiting++;
+    while (writing || nbReaders > 0)
+        tableCond.wait(&tableMutex);
+    nbWritersWaiting--;
+    writing = true;
+    tableMutex.unlock();
+}
+
+void AccountStore::unlockWrite()
+{
+    tableMutex.lock();
+    writing = false;
+    tableCond.notifyAll();
+    tableMutex.unlock();
+}
+
+Account *AccountStore::find(const char *id)
+{
+    uint32_t hash = hashId(id);
+    lockRead();
+    Slot &slot = lookup(id, hash);
+    Account *account = slot.index == 0 ? nullptr : &accounts[slot.index - 1];
+    unlockRead();
+    return account;
+}
+
+Account *AccountStore::insert(const char *id, int amount)
+{
+    size_t length = strlen(id);
+    if (length >= (size_t)MAX_ID_COMPTE)
+        return nullptr;
+
+    uint32_t hash = hashId(id);
+    lockWrite();
+    // Taux de remplissage maximal de 3/4
+    if ((accounts.size() + 1) * 4 > slots.size() * 3)
+        grow();
+
+    Slot &slot = lookup(id, hash);
+    if (slot.index != 0) {
+        unlockWrite();
+        return nullptr;
+    }
+
+    // La longueur est vérifiée: le '\0' final est copié avec l'identifiant
+    Account &account = accounts.emplace_back();
+    memcpy(account.id, id, length + 1);
+    account.amount = amount;
+
+    slot.hash = hash;
+    memcpy(slot.key, id, length + 1);
+    slot.index = accounts.size();
+    unlockWrite();
+    return &account;
+}
+
+Account *AccountStore::create(const char *id)
+{
+    return insert(id, 0);
+}
+
+int AccountStore::getAmount(Account *account)
+{
+    return account->amount.load();
+}
+
+int AccountStore::updateAmount(Account *account, int amount)
+{
+    int current = account->amount.load();
+    int result;
+    do {
+        result = current + amount >= 0 ? current + amount : 0;
+    } while (!account->amount.compare_exchange_weak(current, result));
+    return result;
+}
+
+int AccountStore::debitAmount(Account *account, int amount)
+{
+    int current = account->amount.load();
+    do {
+        if (current < amount)
+            return -1;
+    } while (!account->amount.compare_exchange_weak(current, current - amount));
+    return current - amount;
+}
+
+size_t AccountStore::size()
+{
+    lockRead();
+    size_t nb = accounts.size();
+    unlockRead();
+    return nb;
+}
+
+bool AccountStore::save(const std::string &path)
+{
+    std::string content;
+    lockRead();
+    for (Account &account : accounts)
+        content += std::string(account.id) + ' ' + std::to_string(getAmount(&account)) + '\n';
+    unlockRead();
+
+    // Comme l'instantané de l'inventaire: un arrêt brutal laisse l'ancien ou
+    // le nouveau fichier, jamais un fichier partiel
+    std::string tmpPath = path + ".tmp";
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool written = fd >= 0 && write(fd, content.data(), content.size()) == (ssize_t)content.size()
+                   && fsync(fd) == 0;
+    if (fd >= 0)
+        ::close(fd);
+    return written && rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+bool AccountStore::load(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    std::string id;
+    int amount;
+    while (file >> id >> amount)
+        insert(id.c_str(), amount);
+    return true;
+}
@@ -0,0 +1,120 @@
+/**
+  \file accountstore.h
+  \author Valentin Kaelin & Lazar Pavicevic
+  \date 19.10.2026
+  \brief Déclaration du stockage des comptes de la machine.
+  Les comptes sont indexés par une table de hachage à adressage ouvert dont
+  les cases contiennent directement l'identifiant, ce qui permet de trouver
+  un compte en temps constant sans parcourir de liste.
+*/
+
+#ifndef ACCOUNTSTORE_H
+#define ACCOUNTSTORE_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <pcosynchro/pcomutex.h>
+#include <pcosynchro/pcoconditionvariable.h>
+
+/** Taille maximale d'un identifiant de compte, '\0' compris */
+constexpr int MAX_ID_COMPTE = 25;
+
+/** Un compte client. Son adresse reste valide tant que le stockage existe. */
+struct Account {
+    char id[MAX_ID_COMPTE];
+    // Modifié uniquement par compare-and-swap, sans verrou
+    std::atomic<int> amount;
+};
+
+class AccountStore
+{
+public:
+    AccountStore();
+
+    /** find: Recherche un compte. La table n'est verrouillée en lecture que
+    * le temps du sondage, quelques comparaisons: plusieurs recherches
+    * s'exécutent en parallèle, seul un ajout les fait attendre.
+    * Valeur retournée: le compte, nullptr s'il n'existe pas.
+    */
+    Account *find(const char *id);
+
+    /** create: Crée un compte avec un solde nul.
+    * Valeur retournée: le nouveau compte, nullptr si l'identifiant existe
+    * déjà ou est trop long.
+    */
+    Account *create(const char *id);
+
+    /** getAmount: Retourne le solde d'un compte. */
+    int getAmount(Account *account);
+
+    /** updateAmount: Ajoute une somme, positive ou négative, au solde d'un
+    * compte. Le solde ne peut pas devenir négatif, il est alors mis à zéro.
+    * Valeur retournée: le solde après modification.
+    */
+    int updateAmount(Account *account, int amount);
+
+    /** debitAmount: Débite une somme d'un compte uniquement si son solde
+    * suffit. La vérification et le débit forment une seule opération
+    * atomique.
+    * Valeur retournée: le solde après le débit, -1 si le solde est
+    * insuffisant, auquel cas le compte n'est pas modifié.
+    */
+    int debitAmount(Account *account, int amount);
+
+    /** Nombre de comptes enregistrés */
+    size_t size();
+
+    /** save: Écrit un instantané de tous les comptes dans un fichier, une
+    * ligne "identifiant solde" par compte. Le fichier est écrit sur disque
+    * (fsync) puis remplacé de façon atomique.
+    * Valeur retournée: true si l'écriture a réussi.
+    */
+    bool save(const std::string &path);
+
+    /** load: Ajoute les comptes d'un instantané créé par save. Les comptes
+    * existants sont conservés.
+    * Valeur retournée: true si le fichier a pu être lu.
+    */
+    bool load(const std::string &path);
+
+private:
+    /** Case de la table: index 0 signifie case vide, sinon compte index - 1 */
+    struct Slot {
+        uint32_t hash;
+        uint32_t index;
+        char key[MAX_ID_COMPTE];
+    };
+
+    static uint32_t hashId(const char *id);
+
+    /** Case contenant id, ou case vide où l'insérer. Table verrouillée. */
+    Slot &lookup(const char *id, uint32_t hash);
+
+    /** Double la taille de la table. Table verrouillée en écriture. */
+    void grow();
+
+    /** Verrou lecteurs-rédacteurs de la table. Un rédacteur en attente
+    * bloque les nouveaux lecteurs, qui ne peuvent donc pas l'affamer. */
+    void lockRead();
+    void unlockRead();
+    void lockWrite();
+    void unlockWrite();
+
+    Account *insert(const char *id, int amount);
+
+    std::vector<Slot> slots;
+    // deque: les comptes ne sont jamais déplacés lors d'un ajout
+    std::deque<Account> accounts;
+    // Protègent la table et la liste des comptes, pas les soldes
+    PcoMutex tableMutex;
+    PcoConditionVariable tableCond;
+    int nbReaders{0};
+    int nbWritersWaiting{0};
+    bool writing{false};
+};
+
+#endif // ACCOUNTSTORE_H
@@ -0,0 +1,146 @@
+#include <cstdio>
+
+#include "asynclogger.h"
+
+AsyncLogger &AsyncLogger::instance()
+{
+    static AsyncLogger logger;
+    return logger;
+}
+
+AsyncLogger::AsyncLogger()
+{
+    writer = std::make_unique<PcoThread>(&AsyncLogger::writerRun, this);
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    wakeMutex.lock();
+    stopping = true;
+    wakeCond.notifyOne();
+    wakeMutex.unlock();
+    writer->join();
+}
+
+AsyncLogger::ThreadBuffer &AsyncLogger::local()
+{
+    thread_local ThreadBuffer *buffer = nullptr;
+    if (buffer == nullptr) {
+        buffersMutex.lock();
+        buffers.push_back(std::make_unique<ThreadBuffer>());
+        buffer = buffers.back().get();
+        buffersMutex.unlock();
+    }
+    return *buffer;
+}
+
+void AsyncLogger::push(const Record &record)
+{
+    ThreadBuffer &buffer = local();
+    if (!buffer.ring.tryPush(record)) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        nbDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    nbPushed.fetch_add(1, std::memory_order_release);
+
+    // Le message doit être visible avant la lecture de writerSleeping, le
+    // thread d'écriture faisant l'inverse avant de s'endormir
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (writerSleeping.load(std::memory_order_relaxed)) {
+        wakeMutex.lock();
+        writerSleeping = false;
+        wakeCond.notifyOne();
+        wakeMutex.unlock();
+    }
+}
+
+void AsyncLogger::setLevel(int newLevel)
+{
+    level = newLevel;
+}
+
+int AsyncLogger::getLevel() const
+{
+    return level;
+}
+
+uint64_t AsyncLogger::getNbDropped() const
+{
+    return nbDropped;
+}
+
+void AsyncLogger::flush()
+{
+    uint64_t target = nbPushed.load(std::memory_order_acquire);
+    wakeMutex.lock();
+    while (nbWritten.load(std::memory_order_acquire) < target) {
+        writerSleeping = false;
+        wakeCond.notifyOne();
+        writtenCond.wait(&wakeMutex);
+    }
+    wakeMutex.unlock();
+    fflush(stdout);
+}
+
+size_t AsyncLogger::drain()
+{
+    size_t nbRecords = 0;
+    Record record;
+
+    // Les tampons ne sont jamais retirés, seule la liste est protégée
+    buffersMutex.lock();
+    size_t nbBuffers = buffers.size();
+    buffersMutex.unlock();
+
+    for (size_t i = 0; i < nbBuffers; i++) {
+        buffersMutex.lock();
+        ThreadBuffer *buffer = buffers[i].get();
+        buffersMutex.unlock();
+
+        uint64_t dropped = buffer->dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            fprintf(stdout, "[journal] %llu messages perdus\n", (unsigned long long)dropped);
+        }
+        // Le formatage a lieu ici, hors du chemin critique des producteurs
+        while (buffer->ring.tryPop(record)) {
+            record.write(stdout, record);
+            nbRecords++;
+        }
+    }
+    if (nbRecords > 0) {
+        // Une seule écriture par passage au lieu d'une par message
+        fflush(stdout);
+        nbWritten.fetch_add(nbRecords, std::memory_order_release);
+        wakeMutex.lock();
+        writtenCond.notifyAll();
+        wakeMutex.unlock();
+    }
+    return nbRecords;
+}
+
+void AsyncLogger::writerRun()
+{
+    while (!stopping) {
+        if (drain() > 0) {
+            continue;
+        }
+
+        // S'annonce endormi, puis vérifie une dernière fois les tampons: un
+        // message ajouté entre-temps voit writerSleeping et réveille le thread
+        writerSleeping = true;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (drain() > 0) {
+            writerSleeping = false;
+            continue;
+        }
+
+        wakeMutex.lock();
+        while (writerSleeping && !stopping) {
+            wakeCond.wait(&wakeMutex);
+        }
+        writerSleeping = false;
+        wakeMutex.unlock();
+    }
+    drain();
+}
@@ -0,0 +1,239 @@
+/**
+  \file asynclogger.h
+  \author Valentin Kaelin & Lazar Pavicevic
+  \date 19.10.2026
+  \brief Journal asynchrone pour les chemins critiques de la machine.
+  Chaque thread écrit ses messages dans son propre tampon sans verrou. Un
+  message y est stocké sous forme compacte: l'adresse de son format et la
+  copie brute de ses arguments. Le formatage a lieu dans le thread
+  d'écriture, qui vide les tampons en arrière-plan et dort lorsqu'ils sont
+  vides: un appel de LOG_INFO ne fait que quelques copies, sans jamais
+  attendre la sortie standard. Si un tampon est plein, le message est
+  abandonné et compté.
+*/
+
+#ifndef ASYNCLOGGER_H
+#define ASYNCLOGGER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <pcosynchro/pcothread.h>
+#include <pcosynchro/pcomutex.h>
+#include <pcosynchro/pcoconditionvariable.h>
+
+#include "spscring.h"
+
+/** Niveaux des messages, du plus au moins important */
+#define LOG_LEVEL_ERROR 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_DEBUG 2
+
+/** Niveau maximal compilé, les messages moins importants ne génèrent aucun code */
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+class AsyncLogger
+{
+public:
+    /** Place des arguments d'un message. Les chaînes sont copiées dans la
+     * place laissée par les autres arguments et tronquées si besoin. */
+    static constexpr size_t ARGS_SIZE = 112;
+
+    /** Nombre de messages en attente par thread */
+    static constexpr size_t BUFFER_SIZE = 256;
+
+    /** Journal du processus, démarré au premier appel */
+    static AsyncLogger &instance();
+
+    /** Arrête le thread d'écriture après avoir écrit les messages restants */
+    ~AsyncLogger();
+
+    /**
+     * Ajoute un message au tampon du thread appelant, au format printf.
+     * Le format doit rester valide jusqu'à l'écriture (une chaîne littérale),
+     * les arguments sont des nombres, énumérations, pointeurs ou chaînes C.
+     * Ne bloque jamais: le message est abandonné si le tampon est plein.
+     */
+    template<typename... Args>
+    void log(int messageLevel, const char *format, Args... args)
+    {
+        if (messageLevel > level.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        Record record;
+        record.format = format;
+        record.write = &writeRecord<Args...>;
+        [[maybe_unused]] size_t fixedPos = 0;
+        [[maybe_unused]] size_t stringPos = fixedSize<Args...>();
+        (encode(record, fixedPos, stringPos, args), ...);
+        push(record);
+    }
+
+    /** Vérifie à la compilation un format et ses arguments, jamais appelée */
+    static void checkFormat(const char *, ...) __attribute__((format(printf, 1, 2))) {}
+
+    /** Niveau maximal écrit à l'exécution, au plus LOG_LEVEL */
+    void setLevel(int level);
+
+    int getLevel() const;
+
+    /** Attend que tous les messages déjà ajoutés soient écrits */
+    void flush();
+
+    /** Nombre de messages abandonnés car le tampon de leur thread était plein */
+    uint64_t getNbDropped() const;
+
+private:
+    struct Record {
+        const char *format;
+        // Formate le message, instanciée pour les types de ses arguments
+        void (*write)(FILE *out, const Record &record);
+        // Arguments de taille fixe dans l'ordre, puis les chaînes
+        unsigned char args[ARGS_SIZE];
+    };
+
+    template<typename T>
+    static constexpr bool isString()
+    {
+        return std::is_same<T, const char *>::value || std::is_same<T, char *>::value;
+    }
+
+    template<typename... Args>
+    static constexpr size_t fixedSize()
+    {
+        return (size_t(0) + ... + (isString<Args>() ? 0 : sizeof(Args)));
+    }
+
+    template<typename T>
+    static void encode(Record &record, size_t &fixedPos, size_t &stringPos, T arg)
+    {
+        if constexpr (isString<T>()) {
+            size_t length = arg != nullptr ? strlen(arg) : 0;
+            length = std::min(length, ARGS_SIZE - 1 - std::min(stringPos, ARGS_SIZE - 1));
+            if (stringPos < ARGS_SIZE) {
+                memcpy(record.args + stringPos, arg, length);
+                record.args[stringPos + length] = '\0';
+            }
+            stringPos += length + 1;
+        } else {
+            static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value,
+                          "Seuls les nombres, énumérations, pointeurs et chaînes C peuvent être journalisés");
+            memcpy(record.args + fixedPos, &arg, sizeof(T));
+            fixedPos += sizeof(T);
+        }
+    }
+
+    template<typename T>
+    static T decode(const Record &record, size_t &fixedPos, size_t &stringPos)
+    {
+        if constexpr (isString<T>()) {
+            // Une chaîne sans place est remplacée par la chaîne vide
+            const char *text = stringPos < ARGS_SIZE ? reinterpret_cast<const char *>(record.args + stringPos) : "";
+            stringPos += strlen(text) + 1;
+            return const_cast<T>(text);
+        } else {
+            T value;
+            memcpy(&value, record.args + fixedPos, sizeof(T));
+            fixedPos += sizeof(T);
+            return value;
+        }
+    }
+
+    template<typename... Args>
+    static void writeRecord(FILE *out, const Record &record)
+    {
+        static_assert(fixedSize<Args...>() <= ARGS_SIZE, "Arguments trop grands pour un message");
+        [[maybe_unused]] size_t fixedPos = 0;
+        [[maybe_unused]] size_t stringPos = fixedSize<Args...>();
+        // L'initialisation entre accolades évalue les arguments dans l'ordre
+        std::tuple<Args...> args{decode<Args>(record, fixedPos, stringPos)...};
+        std::apply([&](Args... values) {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-security"
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+            fprintf(out, record.format, values...);
+#pragma GCC diagnostic pop
+        }, args);
+        fputc('\n', out);
+    }
+
+    /** Ajoute un message au tampon du thread appelant et réveille l'écriture */
+    void push(const Record &record);
+
+    struct ThreadBuffer {
+        SpscRing<Record, BUFFER_SIZE> ring;
+        // Abandons pas encore signalés, remis à zéro par le thread d'écriture
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    AsyncLogger();
+
+    /** Tampon du thread appelant, créé et enregistré au premier appel */
+    ThreadBuffer &local();
+
+    /**
+     * Vide une fois tous les tampons.
+     * \return le nombre de messages écrits
+     */
+    size_t drain();
+
+    void writerRun();
+
+    // Les tampons survivent à leur thread afin que leurs messages soient écrits
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    PcoMutex buffersMutex;
+
+    // Le thread d'écriture dort sur wakeCond lorsque les tampons sont vides.
+    // Un producteur ne prend wakeMutex que si writerSleeping est levé.
+    PcoMutex wakeMutex;
+    PcoConditionVariable wakeCond;
+    PcoConditionVariable writtenCond;
+    std::atomic<bool> writerSleeping{false};
+
+    std::atomic<int> level{LOG_LEVEL};
+    std::atomic<uint64_t> nbDropped{0};
+    // Nombre de messages ajoutés et écrits, flush attend leur égalité
+    std::atomic<uint64_t> nbPushed{0};
+    std::atomic<uint64_t> nbWritten{0};
+    std::atomic<bool> stopping{false};
+    std::unique_ptr<PcoThread> writer;
+};
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) do { \
+        if (false) AsyncLogger::checkFormat(__VA_ARGS__); \
+        AsyncLogger::instance().log(LOG_LEVEL_ERROR, __VA_ARGS__); \
+    } while (0)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) do { \
+        if (false) AsyncLogger::checkFormat(__VA_ARGS__); \
+        AsyncLogger::instance().log(LOG_LEVEL_INFO, __VA_ARGS__); \
+    } while (0)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) do { \
+        if (false) AsyncLogger::checkFormat(__VA_ARGS__); \
+        AsyncLogger::instance().log(LOG_LEVEL_DEBUG, __VA_ARGS__); \
+    } while (0)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#endif // ASYNCLOGGER_H
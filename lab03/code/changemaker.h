@@ -0,0 +1,184 @@
+/**
+  \file changemaker.h
+  \author Valentin Kaelin & Lazar Pavicevic
+  \date 19.10.2026
+  \brief Calcul du rendu de monnaie optimal.
+  Ce fichier contient la classe ChangeMaker, qui maintient une table de
+  programmation dynamique (sac à dos borné) donnant pour chaque montant le
+  nombre minimal de pièces avec l'inventaire courant. La table est mise à
+  jour de façon incrémentale lorsque l'inventaire change, un rendu ne coûte
+  ensuite qu'un parcours de la table, sans allocation.
+*/
+
+#ifndef CHANGEMAKER_H
+#define CHANGEMAKER_H
+
+#include <array>
+#include <limits>
+#include <vector>
+
+#include "machineinterface.h"
+
+class ChangeMaker
+{
+public:
+    /** Nombre de types de pièces, de valeur 1 à NB_COINS */
+    static constexpr int NB_COINS = 9;
+
+    ChangeMaker()
+    {
+        best[0].assign(1, 0);
+        for (int value = 1; value <= NB_COINS; value++) {
+            best[value].assign(1, 0);
+        }
+    }
+
+    /**
+     * Relit l'inventaire des pièces de la machine et met à jour la table
+     * si celui-ci a changé.
+     */
+    void update(MachineInterface& machine)
+    {
+        std::array<unsigned, NB_COINS> counts;
+        for (int value = 1; value <= NB_COINS; value++) {
+            counts[value - 1] = machine.getInventoryCoin(value);
+        }
+        setInventory(counts);
+    }
+
+    /**
+     * Met à jour la table pour un nouvel inventaire. Seules les lignes des
+     * pièces dont le nombre a changé, et celles qui en dépendent, sont
+     * recalculées.
+     * Paramètre: nombre de pièces disponibles pour chaque valeur
+     */
+    void setInventory(const std::array<unsigned, NB_COINS>& counts)
+    {
+        int firstChanged = NB_COINS + 1;
+        int newMaxAmount = 0;
+        for (int value = NB_COINS; value >= 1; value--) {
+            if (counts[value - 1] != inventory[value - 1]) {
+                firstChanged = value;
+            }
+            newMaxAmount += value * counts[value - 1];
+        }
+        if (firstChanged > NB_COINS) {
+            return;
+        }
+
+        inventory = counts;
+        // Les lignes inchangées restent valides: les nouveaux montants
+        // qu'elles couvrent sont de toute façon inatteignables
+        if (newMaxAmount > maxAmount) {
+            for (int value = 0; value < firstChanged; value++) {
+                best[value].resize(newMaxAmount + 1, INFINITE);
+            }
+        }
+        maxAmount = newMaxAmount;
+        for (int value = firstChanged; value <= NB_COINS; value++) {
+            computeRow(value);
+        }
+    }
+
+    /**
+     * Calcule la monnaie à rendre.
+     * Paramètres :
+     * - int aRendre                Valeur du montant à rendre
+     * - std::array<int, 9>& rendu  Tableau contenant les pièces à rendre (retour)
+     * - int& renduTot              Valeur de rendu possible (retour)
+     * Retourne vrai si le montant exact peut être rendu. Sinon, le plus grand
+     * montant inférieur pouvant l'être est proposé. Dans les deux cas, le
+     * nombre de pièces est minimal.
+     */
+    bool change(int aRendre, std::array<int, NB_COINS>& rendu, int& renduTot) const
+    {
+        rendu.fill(0);
+
+        int amount = aRendre < maxAmount ? aRendre : maxAmount;
+        while (amount > 0 && best[NB_COINS][amount] == INFINITE) {
+            amount--;
+        }
+        if (amount < 0) {
+            amount = 0;
+        }
+        renduTot = amount;
+
+        // Reconstruction: pour chaque valeur, on retrouve le nombre de pièces
+        // ayant mené au minimum de la ligne
+        for (int value = NB_COINS; value >= 1 && amount > 0; value--) {
+            for (unsigned k = 0; k <= inventory[value - 1] && k * value <= (unsigned)amount; k++) {
+                unsigned previous = best[value - 1][amount - k * value];
+                if (previous != INFINITE && previous + k == best[value][amount]) {
+                    rendu[value - 1] = k;
+                    amount -= k * value;
+                    break;
+                }
+            }
+        }
+
+        return renduTot == aRendre;
+    }
+
+private:
+    static constexpr unsigned INFINITE = std::numeric_limits<unsigned>::max();
+
+    /**
+     * best[v][a]: nombre minimal de pièces de valeur 1 à v pour former le
+     * montant a, INFINITE si impossible. La ligne 0 n'utilise aucune pièce.
+     */
+    std::array<std::vector<unsigned>, NB_COINS + 1> best;
+
+    /** Inventaire correspondant à la table */
+    std::array<unsigned, NB_COINS> inventory{};
+
+    /** Somme de toutes les pièces, plus grand montant atteignable */
+    int maxAmount = 0;
+
+    /** File des candidats de la fenêtre glissante, réutilisée entre les calculs */
+    std::vector<int> window;
+
+    /**
+     * Calcule la ligne de la pièce value à partir de la précédente:
+     * best[v][a] = min(best[v-1][a - k*v] + k) pour 0 <= k <= nombre de pièces.
+     * Pour chaque reste modulo v, le minimum est maintenu sur une fenêtre
+     * glissante de longueur nombre de pièces + 1, soit un coût linéaire en
+     * maxAmount par ligne.
+     */
+    void computeRow(int value)
+    {
+        const std::vector<unsigned>& previous = best[value - 1];
+        std::vector<unsigned>& row = best[value];
+        const int count = inventory[value - 1];
+        row.resize(maxAmount + 1);
+        if (previous.size() < row.size()) {
+            best[value - 1].resize(maxAmount + 1, INFINITE);
+        }
+        if (window.size() < row.size()) {
+            window.resize(row.size());
+        }
+
+        // Les candidats j sont comparés sur previous[r + j*v] - j
+        auto key = [&](int remainder, int j) {
+            return (long)previous[remainder + j * value] - j;
+        };
+
+        for (int remainder = 0; remainder < value && remainder <= maxAmount; remainder++) {
+            int front = 0, back = 0;
+            for (int j = 0; remainder + j * value <= maxAmount; j++) {
+                if (previous[remainder + j * value] != INFINITE) {
+                    while (back > front && key(remainder, window[back - 1]) >= key(remainder, j)) {
+                        back--;
+                    }
+                    window[back++] = j;
+                }
+                while (back > front && window[front] < j - count) {
+                    front++;
+                }
+                row[remainder + j * value] = back > front ?
+                            (unsigned)(key(remainder, window[front]) + j) : INFINITE;
+            }
+        }
+    }
+};
+
+#endif // CHANGEMAKER_H
@@ -0,0 +1,330 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+#include <pcosynchro/pcologger.h>
+
+#include "asynclogger.h"
+#include "fleet.h"
+
+FleetMachine::FleetMachine() : accountOpen(false), credit(0), nbArticlesSold(0)
+{
+    inventoryCoins.fill(3);
+    inventoryArticles.fill(1000);
+}
+
+int FleetMachine::initialize()
+{
+    return 1;
+}
+
+COIN FleetMachine::getCoin()
+{
+    return 0;
+}
+
+ARTICLE FleetMachine::getArticle()
+{
+    return CHOCOLATE;
+}
+
+void FleetMachine::ejectCoin(COIN coin)
+{
+    if (coin > 0 && coin <= 9 && inventoryCoins[coin - 1] > 0) {
+        inventoryCoins[coin - 1]--;
+    }
+}
+
+void FleetMachine::ejectArticle(ARTICLE article)
+{
+    if (inventoryArticles[article] > 0) {
+        inventoryArticles[article]--;
+        nbArticlesSold++;
+    }
+}
+
+bool FleetMachine::ejectPurchase(ARTICLE article, const std::array<int, 9>& rendu)
+{
+    if (inventoryArticles[article] == 0) {
+        return false;
+    }
+    for (size_t i = 0; i < rendu.size(); i++) {
+        if (inventoryCoins[i] < (unsigned)rendu[i]) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < rendu.size(); i++) {
+        inventoryCoins[i] -= rendu[i];
+    }
+    inventoryArticles[article]--;
+    nbArticlesSold++;
+    return true;
+}
+
+unsigned FleetMachine::getInventoryArticle(ARTICLE article)
+{
+    return inventoryArticles[article];
+}
+
+unsigned FleetMachine::getInventoryCoin(COIN coin)
+{
+    return inventoryCoins[coin - 1];
+}
+
+bool FleetMachine::isOpenAccount()
+{
+    return accountOpen;
+}
+
+int FleetMachine::getCreditOpenAccount()
+{
+    return accountOpen ? credit : -1;
+}
+
+int FleetMachine::updateOpenAccount(int amount)
+{
+    if (!accountOpen) {
+        return -1;
+    }
+    credit = credit + amount >= 0 ? credit + amount : 0;
+    return credit;
+}
+
+int FleetMachine::debitOpenAccount(int amount)
+{
+    if (!accountOpen || credit < amount) {
+        return -1;
+    }
+    credit -= amount;
+    return credit;
+}
+
+// Les touches sont livrées directement à MachineManager::onKey
+KEY_STATE FleetMachine::getKeyState()
+{
+    return KEY_UNDEFINED;
+}
+
+KEY_STATE FleetMachine::waitKey(int)
+{
+    return KEY_UNDEFINED;
+}
+
+void FleetMachine::resetKeyFunction()
+{
+}
+
+bool FleetMachine::shouldQuit()
+{
+    return true;
+}
+
+void FleetMachine::insertCoin(COIN coin)
+{
+    inventoryCoins[coin - 1]++;
+}
+
+void FleetMachine::openAccount(int initialCredit)
+{
+    accountOpen = true;
+    credit = initialCredit;
+}
+
+void FleetMachine::closeAccount()
+{
+    accountOpen = false;
+}
+
+uint64_t FleetMachine::getNbArticlesSold() const
+{
+    return nbArticlesSold;
+}
+
+
+Fleet::Fleet(size_t nbMachines, size_t nbWorkers)
+{
+    // Sans thread de travail, aucun événement ne serait traité et waitIdle
+    // attendrait indéfiniment
+    if (nbWorkers < 1) {
+        throw std::invalid_argument("Une flotte doit avoir au moins un thread de travail");
+    }
+    members.reserve(nbMachines);
+    for (size_t i = 0; i < nbMachines; i++) {
+        members.push_back(std::make_unique<Member>());
+    }
+    for (size_t i = 0; i < nbWorkers; i++) {
+        workers.push_back(std::make_unique<PcoThread>(&Fleet::workerRun, this));
+    }
+}
+
+Fleet::~Fleet()
+{
+    queueMutex.lock();
+    stopping = true;
+    queueCond.notifyAll();
+    queueMutex.unlock();
+    for (auto &worker : workers) {
+        worker->join();
+    }
+}
+
+void Fleet::schedule(Member *member)
+{
+    queueMutex.lock();
+    runQueue.push_back(member);
+    queueCond.notifyOne();
+    queueMutex.unlock();
+}
+
+void Fleet::post(size_t machine, FleetEvent event)
+{
+    Member *member = members[machine].get();
+    nbPending++;
+
+    member->mutex.lock();
+    member->mailbox.push_back(event);
+    bool mustSchedule = !member->scheduled;
+    member->scheduled = true;
+    member->mutex.unlock();
+
+    if (mustSchedule) {
+        schedule(member);
+    }
+}
+
+void Fleet::waitIdle()
+{
+    queueMutex.lock();
+    while (nbPending > 0) {
+        idleCond.wait(&queueMutex);
+    }
+    queueMutex.unlock();
+}
+
+size_t Fleet::nbMachines() const
+{
+    return members.size();
+}
+
+uint64_t Fleet::nbEventsProcessed() const
+{
+    return nbProcessed;
+}
+
+uint64_t Fleet::nbArticlesSold() const
+{
+    uint64_t total = 0;
+    for (auto &member : members) {
+        total += member->machine.getNbArticlesSold();
+    }
+    return total;
+}
+
+void Fleet::dispatch(Member &member, const FleetEvent &event)
+{
+    switch (event.type) {
+    case FleetEvent::COIN_INSERTED:
+        member.machine.insertCoin(event.value);
+        member.manager.onCoin(event.value);
+        break;
+    case FleetEvent::ARTICLE_SELECTED:
+        member.manager.onArticle((ARTICLE)event.value);
+        break;
+    case FleetEvent::KEY_PRESSED:
+        member.manager.onKey((KEY_STATE)event.value);
+        break;
+    case FleetEvent::ACCOUNT_OPENED:
+        member.machine.openAccount(event.value);
+        break;
+    case FleetEvent::ACCOUNT_CLOSED:
+        member.machine.closeAccount();
+        break;
+    }
+}
+
+void Fleet::workerRun()
+{
+    while (true) {
+        queueMutex.lock();
+        while (runQueue.empty() && !stopping) {
+            queueCond.wait(&queueMutex);
+        }
+        if (stopping) {
+            queueMutex.unlock();
+            return;
+        }
+        Member *member = runQueue.front();
+        runQueue.pop_front();
+        queueMutex.unlock();
+
+        int nbEvents = 0;
+        bool empty = false;
+        while (nbEvents < BATCH_SIZE) {
+            member->mutex.lock();
+            if (member->mailbox.empty()) {
+                member->scheduled = false;
+                member->mutex.unlock();
+                empty = true;
+                break;
+            }
+            FleetEvent event = member->mailbox.front();
+            member->mailbox.pop_front();
+            member->mutex.unlock();
+
+            dispatch(*member, event);
+            nbEvents++;
+        }
+
+        // Machine encore planifiée: elle reprend sa place en fin de file
+        if (!empty) {
+            schedule(member);
+        }
+
+        nbProcessed += nbEvents;
+        if (nbEvents > 0 && nbPending.fetch_sub(nbEvents) == (uint64_t)nbEvents) {
+            queueMutex.lock();
+            idleCond.notifyAll();
+            queueMutex.unlock();
+        }
+    }
+}
+
+
+int runFleetSimulation(size_t nbMachines, size_t nbWorkers, size_t nbEventsPerMachine)
+{
+    // Les messages de milliers de machines rendraient la mesure illisible
+    AsyncLogger::instance().setLevel(LOG_LEVEL_ERROR);
+
+    Fleet fleet(nbMachines, nbWorkers);
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> eventType(0, 99);
+    std::uniform_int_distribution<int> coin(1, 9);
+    std::uniform_int_distribution<int> article(0, MAX_ARTICLES - 1);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < nbEventsPerMachine; round++) {
+        for (size_t machine = 0; machine < nbMachines; machine++) {
+            int type = eventType(generator);
+            if (type < 60) {
+                fleet.post(machine, {FleetEvent::COIN_INSERTED, coin(generator)});
+            } else if (type < 95) {
+                fleet.post(machine, {FleetEvent::ARTICLE_SELECTED, article(generator)});
+            } else {
+                fleet.post(machine, {FleetEvent::KEY_PRESSED, type % 2 ? KEY_YES : KEY_NO});
+            }
+        }
+    }
+    fleet.waitIdle();
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    AsyncLogger::instance().flush();
+    AsyncLogger::instance().setLevel(LOG_LEVEL);
+    logger() << "Flotte de " << nbMachines << " machines, " << nbWorkers << " threads" << std::endl
+             << "Événements traités: " << fleet.nbEventsProcessed() << " en " << seconds << " s ("
+             << fleet.nbEventsProcessed() / seconds << " événements/s)" << std::endl
+             << "Articles vendus: " << fleet.nbArticlesSold() << std::endl
+             << "Messages perdus: " << AsyncLogger::instance().getNbDropped() << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,155 @@
+/**
+  \file fleet.h
+  \author Valentin Kaelin & Lazar Pavicevic
+  \date 19.10.2026
+  \brief Simulation d'une flotte de machines.
+  Ce fichier déclare une machine simulée en mémoire ainsi que la flotte qui
+  en regroupe un grand nombre. Les événements de chaque machine sont déposés
+  dans sa boîte aux lettres et traités par un petit nombre fixe de threads
+  de travail, au lieu de trois threads par machine.
+*/
+
+#ifndef FLEET_H
+#define FLEET_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <pcosynchro/pcothread.h>
+#include <pcosynchro/pcomutex.h>
+#include <pcosynchro/pcoconditionvariable.h>
+
+#include "machineinterface.h"
+#include "machinemanager.h"
+
+/** Événement destiné à une machine de la flotte */
+struct FleetEvent {
+    enum Type {COIN_INSERTED, ARTICLE_SELECTED, KEY_PRESSED, ACCOUNT_OPENED, ACCOUNT_CLOSED};
+    Type type;
+    // Pièce, article, touche ou crédit initial du compte selon le type
+    int value;
+};
+
+/**
+ * Machine simulée entièrement en mémoire, sans thread ni attente.
+ * Ses événements ne sont pas lus par getCoin, getArticle ou waitKey mais
+ * livrés par la flotte: shouldQuit retourne toujours vrai afin que les
+ * boucles Money et Merchandise se terminent immédiatement si elles sont
+ * lancées. Une machine attendant la réponse d'un client n'occupe donc aucun
+ * thread jusqu'à l'arrivée de la touche.
+ * Une instance n'est utilisée que par un thread de travail à la fois.
+ */
+class FleetMachine : public MachineInterface
+{
+public:
+    FleetMachine();
+
+    int initialize() override;
+    COIN getCoin() override;
+    ARTICLE getArticle() override;
+    void ejectCoin(COIN coin) override;
+    void ejectArticle(ARTICLE article) override;
+    bool ejectPurchase(ARTICLE article, const std::array<int, 9>& rendu) override;
+    unsigned getInventoryArticle(ARTICLE article) override;
+    unsigned getInventoryCoin(COIN coin) override;
+    bool isOpenAccount() override;
+    int getCreditOpenAccount() override;
+    int updateOpenAccount(int amount) override;
+    int debitOpenAccount(int amount) override;
+    KEY_STATE getKeyState() override;
+    KEY_STATE waitKey(int timeoutSeconds) override;
+    void resetKeyFunction() override;
+    bool shouldQuit() override;
+
+    /** Ajoute une pièce reçue à l'inventaire */
+    void insertCoin(COIN coin);
+
+    /** Ouvre le compte simulé avec le crédit donné */
+    void openAccount(int credit);
+
+    void closeAccount();
+
+    uint64_t getNbArticlesSold() const;
+
+private:
+    std::array<unsigned, 9> inventoryCoins;
+    std::array<unsigned, MAX_ARTICLES> inventoryArticles;
+    bool accountOpen;
+    int credit;
+    uint64_t nbArticlesSold;
+};
+
+/**
+ * Flotte de machines simulées. Chaque machine possède une boîte aux lettres;
+ * lorsqu'elle reçoit un événement alors qu'elle n'est pas déjà planifiée, elle
+ * est ajoutée à la file des machines prêtes. Un thread de travail prend une
+ * machine de cette file et traite au plus BATCH_SIZE de ses événements avant
+ * de la replacer en fin de file, ce qui garantit qu'une machine n'est traitée
+ * que par un seul thread à la fois et qu'aucune ne monopolise les threads.
+ */
+class Fleet
+{
+public:
+    /** Nombre maximal d'événements traités d'affilée pour une machine */
+    static constexpr int BATCH_SIZE = 16;
+
+    /** Lève std::invalid_argument si nbWorkers vaut 0 */
+    Fleet(size_t nbMachines, size_t nbWorkers);
+
+    /** Arrête les threads de travail, les événements restants sont abandonnés */
+    ~Fleet();
+
+    /** Dépose un événement dans la boîte aux lettres d'une machine */
+    void post(size_t machine, FleetEvent event);
+
+    /** Attend que tous les événements déposés aient été traités */
+    void waitIdle();
+
+    size_t nbMachines() const;
+
+    uint64_t nbEventsProcessed() const;
+
+    /** Nombre total d'articles vendus, à appeler lorsque la flotte est inactive */
+    uint64_t nbArticlesSold() const;
+
+private:
+    struct Member {
+        FleetMachine machine;
+        MachineManager manager{machine};
+        PcoMutex mutex;
+        std::deque<FleetEvent> mailbox;
+        // Vrai si la machine est dans la file ou en cours de traitement
+        bool scheduled{false};
+    };
+
+    void schedule(Member *member);
+
+    void dispatch(Member &member, const FleetEvent &event);
+
+    void workerRun();
+
+    std::vector<std::unique_ptr<Member>> members;
+
+    PcoMutex queueMutex;
+    PcoConditionVariable queueCond, idleCond;
+    std::deque<Member *> runQueue;
+    bool stopping{false};
+
+    std::atomic<uint64_t> nbPending{0};
+    std::atomic<uint64_t> nbProcessed{0};
+
+    std::vector<std::unique_ptr<PcoThread>> workers;
+};
+
+/**
+ * Simule nbMachines machines recevant chacune nbEventsPerMachine événements
+ * aléatoires, traités par nbWorkers threads, et affiche le débit obtenu.
+ * \return EXIT_SUCCESS
+ */
+int runFleetSimulation(size_t nbMachines, size_t nbWorkers, size_t nbEventsPerMachine);
+
+#endif // FLEET_H
@@ -0,0 +1,367 @@
+#include <cstddef>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "asynclogger.h"
+#include "inventory.h"
+
+Inventory::Inventory(const Coins &coins, const Articles &articles) : coins(coins), articles(articles)
+{
+}
+
+Inventory::~Inventory()
+{
+    close();
+}
+
+void Inventory::close()
+{
+    if (committer) {
+        mutex.lock();
+        stopping = true;
+        pendingCond.notifyOne();
+        mutex.unlock();
+        committer->join();
+        committer.reset();
+        // Le prochain démarrage n'aura aucune transaction à rejouer
+        checkpoint();
+    }
+    if (walFd >= 0) {
+        mutex.lock();
+        ::close(walFd);
+        walFd = -1;
+        // L'inventaire reste utilisable en mémoire
+        readOnly = false;
+        mutex.unlock();
+    }
+}
+
+template<typename T>
+uint32_t Inventory::checksum(const T &data)
+{
+    // FNV-1a sur tout l'enregistrement sauf le champ checksum, en dernier
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&data);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < offsetof(T, checksum); i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool Inventory::open(const std::string &path)
+{
+    snapshotPath = path + ".snap";
+    walPath = path + ".wal";
+    // Un inventaire fermé peut être rouvert
+    stopping = false;
+    readOnly = false;
+    walFailed = false;
+    failedSeq = 0;
+    if (!recover()) {
+        if (walFd >= 0) {
+            ::close(walFd);
+            walFd = -1;
+        }
+        return false;
+    }
+    committer = std::make_unique<PcoThread>(&Inventory::committerRun, this);
+    return true;
+}
+
+bool Inventory::recover()
+{
+    FILE *file = fopen(snapshotPath.c_str(), "rb");
+    if (file != nullptr) {
+        Snapshot snapshot;
+        bool valid = fread(&snapshot, sizeof(snapshot), 1, file) == 1 && snapshot.checksum == checksum(snapshot);
+        fclose(file);
+        if (!valid) {
+            LOG_ERROR("Instantané de l'inventaire corrompu: %s", snapshotPath.c_str());
+            return false;
+        }
+        coins = snapshot.coins;
+        articles = snapshot.articles;
+        lastSeq = snapshot.seq;
+    }
+
+    walFd = ::open(walPath.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (walFd < 0) {
+        return false;
+    }
+
+    // Rejoue les transactions postérieures à l'instantané, ou toutes si
+    // aucun instantané n'existe, jusqu'au premier enregistrement incomplet
+    // ou invalide
+    WalRecord record;
+    off_t validSize = 0;
+    uint64_t nbReplayed = 0;
+    while (pread(walFd, &record, sizeof(record), validSize) == sizeof(record)
+           && record.checksum == checksum(record)) {
+        if (record.seq > lastSeq) {
+            for (int i = 0; i < NB_COINS; i++) {
+                coins[i] += record.delta.coins[i];
+            }
+            for (size_t i = 0; i < MAX_ARTICLES; i++) {
+                articles[i] += record.delta.articles[i];
+            }
+            lastSeq = record.seq;
+            nbReplayed++;
+        }
+        validSize += sizeof(record);
+    }
+    if (ftruncate(walFd, validSize) != 0) {
+        return false;
+    }
+    walSize = validSize;
+    committedSeq = lastSeq;
+    nbRecordsSinceCheckpoint = nbReplayed;
+
+    // Premier démarrage: l'état initial doit être durable avant toute
+    // transaction, le journal ne contenant que des différences
+    if (file == nullptr) {
+        return checkpoint();
+    }
+    return true;
+}
+
+bool Inventory::checkpoint()
+{
+    Snapshot snapshot{};
+    mutex.lock();
+    snapshot.seq = lastSeq;
+    snapshot.coins = coins;
+    snapshot.articles = articles;
+    mutex.unlock();
+    snapshot.checksum = checksum(snapshot);
+
+    // Remplacement atomique: un arrêt brutal laisse l'ancien ou le nouvel instantané
+    std::string tmpPath = snapshotPath + ".tmp";
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool written = fd >= 0 && write(fd, &snapshot, sizeof(snapshot)) == sizeof(snapshot) && fsync(fd) == 0;
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    if (!written || rename(tmpPath.c_str(), snapshotPath.c_str()) != 0) {
+        LOG_ERROR("Impossible d'écrire l'instantané de l'inventaire");
+        return false;
+    }
+
+    // Les transactions restantes du journal sont toutes dans l'instantané.
+    // Celles du lot en cours, écrites ensuite, seront ignorées à la reprise.
+    if (ftruncate(walFd, 0) != 0) {
+        LOG_ERROR("Impossible de vider le journal de l'inventaire");
+        return false;
+    }
+    walSize = 0;
+    nbRecordsSinceCheckpoint = 0;
+    return true;
+}
+
+void Inventory::committerRun()
+{
+    std::vector<WalRecord> batch;
+
+    while (true) {
+        mutex.lock();
+        while (pending.empty() && !stopping) {
+            pendingCond.wait(&mutex);
+        }
+        if (pending.empty()) {
+            mutex.unlock();
+            return;
+        }
+        // Toutes les transactions arrivées depuis le dernier commit
+        batch.swap(pending);
+        mutex.unlock();
+
+        uint64_t seq = batch.back().seq;
+        if (!walFailed && !writeBatch(batch)) {
+            // Les transactions suivantes auraient besoin de celles-ci à la
+            // reprise: le journal s'arrête au dernier lot complet et
+            // l'inventaire revient à l'état qu'il décrit
+            LOG_ERROR("Écriture du journal de l'inventaire impossible, journalisation interrompue");
+            walFailed = true;
+            mutex.lock();
+            rollback(batch);
+            seq = lastSeq;
+            mutex.unlock();
+        }
+
+        durableMutex.lock();
+        if (walFailed) {
+            failedSeq = seq;
+        } else {
+            committedSeq = seq;
+        }
+        durableCond.notifyAll();
+        durableMutex.unlock();
+
+        if (walFailed) {
+            batch.clear();
+            continue;
+        }
+        nbRecordsSinceCheckpoint += batch.size();
+        batch.clear();
+        if (nbRecordsSinceCheckpoint >= CHECKPOINT_RECORDS) {
+            checkpoint();
+        }
+    }
+}
+
+bool Inventory::writeBatch(const std::vector<WalRecord> &batch)
+{
+    size_t size = batch.size() * sizeof(WalRecord);
+    for (int attempt = 0; attempt < WRITE_ATTEMPTS; attempt++) {
+        if (write(walFd, batch.data(), size) == (ssize_t)size && fdatasync(walFd) == 0) {
+            walSize += size;
+            return true;
+        }
+        // Retire un lot écrit en partie, qui masquerait les suivants à la reprise
+        if (ftruncate(walFd, walSize) != 0) {
+            return false;
+        }
+    }
+    return false;
+}
+
+uint64_t Inventory::apply(const Delta &delta)
+{
+    for (int i = 0; i < NB_COINS; i++) {
+        coins[i] += delta.coins[i];
+    }
+    for (size_t i = 0; i < MAX_ARTICLES; i++) {
+        articles[i] += delta.articles[i];
+    }
+    // Après close(), les modifications ne sont plus journalisées
+    if (walFd < 0 || stopping) {
+        return 0;
+    }
+
+    WalRecord record{};
+    record.seq = ++lastSeq;
+    record.delta = delta;
+    record.checksum = checksum(record);
+    pending.push_back(record);
+    pendingCond.notifyOne();
+    return record.seq;
+}
+
+void Inventory::rollback(const std::vector<WalRecord> &batch)
+{
+    // Les transactions en attente dépendent peut-être de celles du lot:
+    // tout est annulé ensemble, sans état intermédiaire visible
+    auto undo = [this](const WalRecord &record) {
+        for (int i = 0; i < NB_COINS; i++) {
+            coins[i] -= record.delta.coins[i];
+        }
+        for (size_t i = 0; i < MAX_ARTICLES; i++) {
+            articles[i] -= record.delta.articles[i];
+        }
+    };
+    for (const WalRecord &record : batch) {
+        undo(record);
+    }
+    for (const WalRecord &record : pending) {
+        undo(record);
+    }
+    pending.clear();
+    readOnly = true;
+}
+
+bool Inventory::waitDurable(uint64_t seq)
+{
+    durableMutex.lock();
+    while (committedSeq < seq && failedSeq < seq) {
+        durableCond.wait(&durableMutex);
+    }
+    bool durable = committedSeq >= seq;
+    durableMutex.unlock();
+    return durable;
+}
+
+bool Inventory::commit(const Delta &delta)
+{
+    mutex.lock();
+    if (readOnly) {
+        mutex.unlock();
+        return false;
+    }
+    uint64_t seq = apply(delta);
+    mutex.unlock();
+    return waitDurable(seq);
+}
+
+unsigned Inventory::getCoin(COIN coin)
+{
+    mutex.lock();
+    unsigned count = coins[coin - 1];
+    mutex.unlock();
+    return count;
+}
+
+unsigned Inventory::getArticle(ARTICLE article)
+{
+    mutex.lock();
+    unsigned count = articles[article];
+    mutex.unlock();
+    return count;
+}
+
+bool Inventory::addCoin(COIN coin)
+{
+    Delta delta{};
+    delta.coins[coin - 1] = 1;
+    return commit(delta);
+}
+
+bool Inventory::takeCoin(COIN coin)
+{
+    Delta delta{};
+    delta.coins[coin - 1] = -1;
+    mutex.lock();
+    if (readOnly || coins[coin - 1] == 0) {
+        mutex.unlock();
+        return false;
+    }
+    uint64_t seq = apply(delta);
+    mutex.unlock();
+    return waitDurable(seq);
+}
+
+bool Inventory::takeArticle(ARTICLE article)
+{
+    Delta delta{};
+    delta.articles[article] = -1;
+    mutex.lock();
+    if (readOnly || articles[article] == 0) {
+        mutex.unlock();
+        return false;
+    }
+    uint64_t seq = apply(delta);
+    mutex.unlock();
+    return waitDurable(seq);
+}
+
+bool Inventory::reservePurchase(ARTICLE article, const std::array<int, NB_COINS> &rendu)
+{
+    Delta delta{};
+    delta.articles[article] = -1;
+    for (int i = 0; i < NB_COINS; i++) {
+        delta.coins[i] = -rendu[i];
+    }
+
+    mutex.lock();
+    bool available = !readOnly && articles[article] > 0;
+    for (int i = 0; i < NB_COINS && available; i++) {
+        available = coins[i] >= (unsigned)rendu[i];
+    }
+    if (!available) {
+        mutex.unlock();
+        return false;
+    }
+    uint64_t seq = apply(delta);
+    mutex.unlock();
+    return waitDurable(seq);
+}
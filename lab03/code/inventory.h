@@ -0,0 +1,199 @@
+/**
+  \file inventory.h
+  \author Valentin Kaelin & Lazar Pavicevic
+  \date 19.10.2026
+  \brief Inventaire transactionnel des pièces et articles de la machine.
+  Chaque modification de l'inventaire est une transaction: un achat réserve
+  l'article et toutes les pièces du rendu ensemble, ou rien. Lorsqu'un
+  fichier est ouvert, les transactions sont inscrites dans un journal
+  (write-ahead log) écrit par lots par un thread dédié: les transactions
+  concurrentes partagent un même fdatasync. Au démarrage, l'inventaire est
+  reconstruit à partir du dernier instantané et de la fin du journal.
+*/
+
+#ifndef INVENTORY_H
+#define INVENTORY_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+#include <pcosynchro/pcothread.h>
+#include <pcosynchro/pcomutex.h>
+#include <pcosynchro/pcoconditionvariable.h>
+
+#include "machineinterface.h"
+
+class Inventory
+{
+public:
+    /** Nombre de types de pièces, de valeur 1 à NB_COINS */
+    static constexpr int NB_COINS = 9;
+
+    /** Nombre de transactions journalisées avant un nouvel instantané */
+    static constexpr uint64_t CHECKPOINT_RECORDS = 4096;
+
+    /** Nombre d'essais d'écriture d'un lot avant d'interrompre le journal */
+    static constexpr int WRITE_ATTEMPTS = 3;
+
+    using Coins = std::array<unsigned, NB_COINS>;
+    using Articles = std::array<unsigned, MAX_ARTICLES>;
+
+    /** Inventaire en mémoire, utilisé tel quel si aucun fichier n'est ouvert */
+    Inventory(const Coins &coins, const Articles &articles);
+
+    /** Appelle close() */
+    ~Inventory();
+
+    /**
+     * Récupère l'inventaire persistant puis démarre la journalisation.
+     * path.snap contient le dernier instantané et path.wal les transactions
+     * suivantes. Si aucun instantané n'existe, l'inventaire courant sert
+     * d'état initial, complété par le journal, puis est écrit comme premier
+     * instantané. Une fin de journal incomplète (arrêt brutal pendant une
+     * écriture) est ignorée et tronquée.
+     * \return false si les fichiers ne peuvent pas être ouverts ou si
+     * l'instantané initial ne peut pas être écrit
+     */
+    bool open(const std::string &path);
+
+    /**
+     * Écrit les transactions en attente, arrête le thread du journal et
+     * écrit un instantané final. L'inventaire reste utilisable en mémoire.
+     */
+    void close();
+
+    unsigned getCoin(COIN coin);
+
+    unsigned getArticle(ARTICLE article);
+
+    /**
+     * Ajoute une pièce reçue
+     * \return false si le journal n'a pas pu l'enregistrer
+     */
+    bool addCoin(COIN coin);
+
+    /**
+     * Retire une pièce si elle est disponible
+     * \return false si aucune pièce de cette valeur ne reste ou si le
+     * journal n'a pas pu enregistrer le retrait
+     */
+    bool takeCoin(COIN coin);
+
+    /**
+     * Retire un article s'il est disponible
+     * \return false si l'article est épuisé ou si le journal n'a pas pu
+     * enregistrer le retrait
+     */
+    bool takeArticle(ARTICLE article);
+
+    /**
+     * Réserve un article et les pièces d'un rendu en une seule transaction.
+     * Si l'un d'eux manque, rien n'est retiré.
+     * \param rendu nombre de pièces de chaque valeur à rendre
+     * \return true si la réservation a eu lieu et est écrite sur disque
+     */
+    bool reservePurchase(ARTICLE article, const std::array<int, NB_COINS> &rendu);
+
+    /**
+     * Retourne une fois la transaction seq écrite sur disque. Les
+     * modifications journalisées y font appel avant de retourner.
+     * \return false si le journal n'a pas pu être écrit: la transaction a
+     * été annulée en mémoire
+     */
+    bool waitDurable(uint64_t seq);
+
+private:
+    // Modification de l'inventaire produite par une transaction
+    struct Delta {
+        int16_t coins[NB_COINS];
+        int16_t articles[MAX_ARTICLES];
+    };
+
+    // Enregistrement du journal, de taille fixe
+    struct WalRecord {
+        uint64_t seq;
+        Delta delta;
+        uint32_t checksum;
+    };
+
+    // Instantané de l'inventaire après la transaction seq
+    struct Snapshot {
+        uint64_t seq;
+        Coins coins;
+        Articles articles;
+        uint32_t checksum;
+    };
+
+    template<typename T>
+    static uint32_t checksum(const T &data);
+
+    /**
+     * Applique une transaction déjà validée, mutex pris, et la place dans le
+     * lot du prochain commit.
+     * \return son numéro de séquence, 0 si aucun journal n'est ouvert
+     */
+    uint64_t apply(const Delta &delta);
+
+    /**
+     * Annule les transactions d'un lot et celles en attente, mutex pris:
+     * l'inventaire revient au dernier état écrit sur disque
+     */
+    void rollback(const std::vector<WalRecord> &batch);
+
+    /**
+     * Applique puis attend l'écriture sur disque
+     * \return false si la transaction a été refusée ou annulée
+     */
+    bool commit(const Delta &delta);
+
+    bool recover();
+
+    /**
+     * Écrit un instantané de l'inventaire puis vide le journal
+     * \return false si l'instantané ou le journal n'a pas pu être écrit
+     */
+    bool checkpoint();
+
+    void committerRun();
+
+    /**
+     * Ajoute un lot au journal puis le synchronise, en réessayant après avoir
+     * tronqué un lot incomplet. Appelée par le thread du journal uniquement.
+     * \return false si le lot n'a pas pu être écrit
+     */
+    bool writeBatch(const std::vector<WalRecord> &batch);
+
+    std::string snapshotPath, walPath;
+    int walFd{-1};
+    // Taille du journal après le dernier lot complet, propre au thread du journal
+    off_t walSize{0};
+    // Une écriture a échoué: les lots suivants ne sont plus écrits
+    bool walFailed{false};
+
+    // Protège l'état, la séquence et le lot en attente
+    PcoMutex mutex;
+    PcoConditionVariable pendingCond;
+    Coins coins;
+    Articles articles;
+    uint64_t lastSeq{0};
+    std::vector<WalRecord> pending;
+    bool stopping{false};
+    // Le journal est interrompu: les modifications sont refusées jusqu'à close()
+    bool readOnly{false};
+
+    // Protège committedSeq et failedSeq
+    PcoMutex durableMutex;
+    PcoConditionVariable durableCond;
+    uint64_t committedSeq{0};
+    // Dernière transaction dont l'écriture a échoué
+    uint64_t failedSeq{0};
+
+    uint64_t nbRecordsSinceCheckpoint{0};
+    std::unique_ptr<PcoThread> committer;
+};
+
+#endif // INVENTORY_H
@@ -1,29 +1,30 @@
 
 
+#include <chrono>
 #include <iostream>
 #include <string.h>
 
 #include <pcosynchro/pcothread.h>
 #include <pcosynchro/pcologger.h>
+#include <pcosynchro/pcomutex.h>
 
+#include "accountstore.h"
+#include "asynclogger.h"
+#include "inventory.h"
 #include "machine.h"
 
-/** InventoryCoins: inventaire des coins de monnaies dans la machine. */
-static std::array<unsigned, 9> InventoryCoins = {3,3,3,3,3,3,3,3,3};
-//static std::array<unsigned, 9> InventoryCoins = {0,0,0,0,0,0,0,0,0};
+/** Inventaire des pièces et articles, valeurs initiales au premier démarrage */
+static Inventory inventory({3,3,3,3,3,3,3,3,3}, {4,4,4,4});
+//static Inventory inventory({0,0,0,0,0,0,0,0,0}, {4,4,4,4});
 
-/** InventoryItem: inventaire des items distribuables dans la machine. */
-static std::array<unsigned, MAX_ARTICLES> InventoryItem = {4,4,4,4};
+/** Fichiers de l'inventaire: instantané (.snap) et journal (.wal) */
+static const char *INVENTORY_FILE = "inventaire";
 
 /** Gestion des comptes */
-#define MAX_ID_COMPTE 25
-typedef struct LISTCOMPTE {
-    char id[MAX_ID_COMPTE];
-    int amount;
-    struct LISTCOMPTE *next;
-} LISTCOMPTE;
+static AccountStore accounts;
 
-extern LISTCOMPTE *currentAccount;
+/** Fichier contenant l'instantané des comptes entre deux exécutions */
+static const char *ACCOUNTS_FILE = "comptes.txt";
 
 Machine::Machine()
 {
@@ -33,10 +34,18 @@ Machine::~Machine()
 {
     if (threadButton.get() != nullptr) {
         threadButton->join();
+        // Les threads du gestionnaire sont terminés: plus aucune transaction
+        // ne peut modifier les comptes ou l'inventaire
+        if (!accounts.save(ACCOUNTS_FILE))
+            LOG_ERROR("Impossible de sauvegarder les comptes.");
+        inventory.close();
     }
 }
 
 int Machine::initialize(){
+    accounts.load(ACCOUNTS_FILE);
+    if (!inventory.open(INVENTORY_FILE))
+        LOG_ERROR("Inventaire non persistant: impossible d'ouvrir %s", INVENTORY_FILE);
     threadButton = std::make_unique<PcoThread>(&Machine::processKey, this);
     return 1;
 }
@@ -74,13 +83,18 @@ void Machine::closeAction()
 
 
 
-/** Key_State: derniere touche presse par l'usager. */
-static KEY_STATE Key_State = KEY_UNDEFINED;
+/** Compte ouvert, nullptr si aucun. Protégé par accountMutex: la fermeture
+ * attend qu'une modification du compte en cours soit terminée. */
+static Account *currentAccount = nullptr;
+static PcoMutex accountMutex;
 
-
-LISTCOMPTE *currentAccount;
-
-static LISTCOMPTE *listAccounts;
+/** Remplace le compte ouvert */
+static void setCurrentAccount(Account *compte)
+{
+    accountMutex.lock();
+    currentAccount = compte;
+    accountMutex.unlock();
+}
 
 static int GetAccountId(char *name)
 {
@@ -101,37 +115,16 @@ static int GetAccountId(char *name)
 }
 
 
-static LISTCOMPTE *GetAccount(char *name)
-{
-    LISTCOMPTE *compte;
-    int i;
-    for (compte = listAccounts; compte != nullptr; compte = compte->next)
-        if ((i = strcmp(name,compte->id)) == 0)
-            return compte;
-        else if (i < 0) break;
-            return nullptr;
-}
-
 void Machine::openNewAccount(void)
 {
-    LISTCOMPTE *compte, *pred;
+    Account *compte;
     char name[MAX_ID_COMPTE];
     if (GetAccountId(name)) {
-        if (GetAccount(name) != nullptr)
+        if ((compte = accounts.create(name)) == nullptr)
             logger() << "Le compte " << name << " existe déja. Votre opération est annulée." << std::endl;
-        else if ((compte = (LISTCOMPTE *)malloc(sizeof(LISTCOMPTE))) != nullptr) {
-            strncpy(compte->id,name,MAX_ID_COMPTE); compte->amount = 0;
-        if (listAccounts == nullptr || strcmp(listAccounts->id,compte->id) > 0) {
-            compte->next = listAccounts; listAccounts = compte;
-        }
         else {
-            for (pred = listAccounts; pred->next; pred = pred->next)
-                if (strcmp(pred->next->id,compte->id) > 0)
-                    break;
-            compte->next = pred->next; pred->next = compte;
-        }
-        currentAccount = compte;
-        logger() << "Solde du compte " << compte->id << ": " << currentAccount->amount << std::endl;
+            setCurrentAccount(compte);
+            logger() << "Solde du compte " << compte->id << ": " << accounts.getAmount(compte) << std::endl;
         }
     }
 
@@ -141,12 +134,14 @@ void Machine::openNewAccount(void)
 
 void Machine::openOldAccount(void)
 {
+    Account *compte;
     char name[MAX_ID_COMPTE];
     if (GetAccountId(name)) {
-        if ((currentAccount = GetAccount(name)) == nullptr)
+        setCurrentAccount(compte = accounts.find(name));
+        if (compte == nullptr)
             logger() << "Le compte " << name << " n'existe pas." << std::endl;
         else
-            logger() << "Solde du compte " << name << ": " << currentAccount->amount << std::endl;
+            logger() << "Solde du compte " << name << ": " << accounts.getAmount(compte) << std::endl;
 
     }
     m_key.release();
@@ -155,11 +150,12 @@ void Machine::openOldAccount(void)
 
 void Machine::closeCurrentAccount(void)
 {
-    if (currentAccount != nullptr)
-        logger() << "Fermeture du compte " << currentAccount->id << " "
-"avec solde de " << currentAccount->amount << std::endl;
-
+    accountMutex.lock();
+    Account *compte = currentAccount;
     currentAccount = nullptr;
+    accountMutex.unlock();
+    if (compte != nullptr)
+        LOG_INFO("Fermeture du compte %s avec solde de %d", compte->id, accounts.getAmount(compte));
 }
 
 
@@ -170,12 +166,12 @@ void Machine::closeCurrentAccount(void)
 
 unsigned Machine::getInventoryArticle(ARTICLE item)
 {
-    return InventoryItem[item];
+    return inventory.getArticle(item);
 }
 
 unsigned Machine::getInventoryCoin(COIN coin)
 {
-    return InventoryCoins[coin-1];
+    return inventory.getCoin(coin);
 }
 
 
@@ -195,36 +191,73 @@ ARTICLE Machine::getArticle()
 
 bool Machine::isOpenAccount()
 {
-    return currentAccount != nullptr;
+    accountMutex.lock();
+    bool open = currentAccount != nullptr;
+    accountMutex.unlock();
+    return open;
 }
 
 int Machine::getCreditOpenAccount()
 {
-    if (currentAccount != nullptr)
-        return currentAccount->amount;
-    else
-        return -1;
+    accountMutex.lock();
+    int credit = currentAccount != nullptr ? accounts.getAmount(currentAccount) : -1;
+    accountMutex.unlock();
+    return credit;
 }
 
 int Machine::updateOpenAccount(int amount)
 {
-    if (currentAccount != nullptr)
-        if (currentAccount->amount + amount >= 0)
-            return currentAccount->amount += amount;
-        else
-            return currentAccount->amount = 0;
-    else
-        return -1;
+    accountMutex.lock();
+    int credit = currentAccount != nullptr ? accounts.updateAmount(currentAccount, amount) : -1;
+    accountMutex.unlock();
+    return credit;
+}
+
+int Machine::debitOpenAccount(int amount)
+{
+    accountMutex.lock();
+    int credit = currentAccount != nullptr ? accounts.debitAmount(currentAccount, amount) : -1;
+    accountMutex.unlock();
+    return credit;
 }
 
 KEY_STATE Machine::getKeyState(void)
 {
-    return Key_State;
+    m_keyMutex.lock();
+    KEY_STATE key = m_keyState;
+    m_keyMutex.unlock();
+    return key;
+}
+
+KEY_STATE Machine::waitKey(int timeoutSeconds)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeoutSeconds);
+    m_keyMutex.lock();
+    while (m_keyState == KEY_UNDEFINED && !shouldQuit()) {
+        auto remaining = std::chrono::ceil<std::chrono::seconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            break;
+        }
+        m_keyPressed.waitForSeconds(&m_keyMutex, remaining.count());
+    }
+    KEY_STATE key = m_keyState;
+    m_keyMutex.unlock();
+    return key;
 }
 
 void Machine::resetKeyFunction(void)
 {
-    Key_State = KEY_UNDEFINED;
+    m_keyMutex.lock();
+    m_keyState = KEY_UNDEFINED;
+    m_keyMutex.unlock();
+}
+
+void Machine::pressKey(KEY_STATE key)
+{
+    m_keyMutex.lock();
+    m_keyState = key;
+    m_keyPressed.notifyAll();
+    m_keyMutex.unlock();
 }
 
 
@@ -235,13 +268,9 @@ void Machine::ejectCoin(COIN coin)
 {
     if (coin > 0 && coin <= 9) {
         PcoThread::usleep(1000000);
-        m_mutex.lock();
-        if (InventoryCoins[coin-1] > 0) {
-            InventoryCoins[coin-1] -= 1;
-            logger() << "Sortie pièce " << coin << std::endl;
-
+        if (inventory.takeCoin(coin)) {
+            LOG_INFO("Sortie pièce %d", coin);
         }
-        m_mutex.unlock();
     }
 }
 
@@ -249,21 +278,39 @@ void Machine::ejectArticle(ARTICLE item)
 {
     if (item >= 0 /* && item < MAX_ARTICLES*/) {
         PcoThread::usleep(2000000);
-        m_mutex.lock();
-        if (InventoryItem[item] > 0) {
-            InventoryItem[item] -= 1;
-            logger() << "Sortie " << std::endl;
+        if (inventory.takeArticle(item)) {
             switch (item) {
-                case CHOCOLATE: logger() << "Chocolate" << std::endl; break;
-                case CANDYCANE: logger() << "Candy cane" << std::endl; break;
-                case GUMMYBEAR: logger() << "Gummy bear" << std::endl; break;
-                default: logger() << "Lollipop" << std::endl;
+                case CHOCOLATE: LOG_INFO("Sortie \nChocolate"); break;
+                case CANDYCANE: LOG_INFO("Sortie \nCandy cane"); break;
+                case GUMMYBEAR: LOG_INFO("Sortie \nGummy bear"); break;
+                default: LOG_INFO("Sortie \nLollipop");
             }
         }
-        m_mutex.unlock();
     }
 }
 
+bool Machine::ejectPurchase(ARTICLE item, const std::array<int, 9>& rendu)
+{
+    if (!inventory.reservePurchase(item, rendu))
+        return false;
+
+    // Article et pièces sont réservés, leur sortie ne peut plus échouer
+    PcoThread::usleep(2000000);
+    switch (item) {
+        case CHOCOLATE: LOG_INFO("Sortie \nChocolate"); break;
+        case CANDYCANE: LOG_INFO("Sortie \nCandy cane"); break;
+        case GUMMYBEAR: LOG_INFO("Sortie \nGummy bear"); break;
+        default: LOG_INFO("Sortie \nLollipop");
+    }
+    for (size_t i = 0; i < rendu.size(); i++) {
+        for (int j = 0; j < rendu[i]; j++) {
+            PcoThread::usleep(1000000);
+            LOG_INFO("Sortie pièce %d", (int)i + 1);
+        }
+    }
+    return true;
+}
+
 
 
 
@@ -282,18 +329,16 @@ void Machine::processKey()
        // logger() << "Char: " << car << std::endl;
        switch (car) {
            case '&':
-               Key_State = KEY_YES;
+               pressKey(KEY_YES);
            break;
            case '/':
-               Key_State = KEY_NO;
+               pressKey(KEY_NO);
            break;
            case '1':  case '2':  case '3':  case '4':  case '5':  case '6':
            case '7':  case '8':  case '9':
                car -= '0';
-               if (bufferCoinsIntroduction.put(car)) {
-                   m_mutex.lock();
-                   InventoryCoins[car - 1] ++;
-                   m_mutex.unlock();
+               if (bufferCoinsIntroduction.putForSeconds(car, 1) && !inventory.addCoin(car)) {
+                   LOG_ERROR("Pièce %d absente de l'inventaire persistant", car);
                }
                m_coin.release();
            break;
@@ -346,7 +391,11 @@ void Machine::quit()
     m_mutex.lock();
     m_shouldQuit = true;
     m_mutex.unlock();
-    bufferCoinsIntroduction.put(0);
+    // Libère un client en attente de confirmation
+    m_keyMutex.lock();
+    m_keyPressed.notifyAll();
+    m_keyMutex.unlock();
+    bufferCoinsIntroduction.putForSeconds(0, 1);
     bufferArticleIntroduction.put((ARTICLE)0);
 
     m_openAccount.release();
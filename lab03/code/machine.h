@@ -22,6 +22,7 @@
 #include <pcosynchro/pcoconditionvariable.h>
 
 #include "machineinterface.h"
+#include "spscring.h"
 
 
 class Machine : public MachineInterface
@@ -29,6 +30,11 @@ class Machine : public MachineInterface
 
 public:
     Machine();
+
+    /**
+    * \brief Attend la fin du thread des touches, puis sauvegarde les comptes et
+    * ferme l'inventaire. Les threads de MachineManager doivent être terminés.
+    */
     virtual ~Machine();
 
     /** Réalise toutes les initialisations nécessaire. Cette fonction
@@ -65,6 +71,14 @@ public:
     */
     void ejectArticle(ARTICLE article) override;
 
+    /** ejectPurchase: Réserve ensemble un article et les pièces du rendu,
+    * puis les éjecte. La réservation est écrite dans le journal de
+    * l'inventaire avant l'éjection.
+    * Valeur retournée: true si l'achat a été éjecté, false si l'article ou
+    * l'une des pièces manque.
+    */
+    bool ejectPurchase(ARTICLE article, const std::array<int, 9>& rendu) override;
+
     /** getInventoryArticle: Retourne le nombre d'items d'un article donné
     * encore disponibles dans la machine.
     * Paramètre: l'article dont on souhaite connaître le nombre restant.
@@ -96,6 +110,13 @@ public:
     */
     int updateOpenAccount(int amount) override;
 
+    /** debitOpenAccount: Débite le compte ouvert uniquement si son solde
+    * suffit, de façon atomique.
+    * Valeur retournée: la somme restant sur le compte après le débit, -1 si
+    * aucun compte n'est ouvert ou si le solde est insuffisant.
+    */
+    int debitOpenAccount(int amount) override;
+
     /** getKeyState: Retourne la derniere touche lue parmi les touches '&'
     * et '/'.
     * Valeur retournee: une valeur dans l'ensemble {KEY_YES,KEY_NO,
@@ -103,6 +124,13 @@ public:
     */
     KEY_STATE getKeyState() override;
 
+    /** waitKey: Attente bloquante jusqu'à ce que l'une des touches '&' ou
+    * '/' soit pressée, au plus timeoutSeconds secondes.
+    * Valeur retournée: KEY_YES ou KEY_NO, KEY_UNDEFINED si le délai a expiré
+    * ou si le programme doit se terminer.
+    */
+    KEY_STATE waitKey(int timeoutSeconds) override;
+
     /** resetKeyFunction: Remise a zero de la memoire associee aux tou-
     * ches '&' et '/'. Suite a l'appel de cette procedure, la fonction
     * Machine_GetEtatTouche renvoie la valeur KEY_UNDEFINED.
@@ -138,117 +166,15 @@ protected:
 
     void processKey();
 
-    void quit();
-
-    template<typename T> class BufferN {
-    protected:
-        std::vector<T> elements;
-        int writePointer, readPointer, nbElements, bufferSize;
-        PcoMutex mutex;
-        PcoConditionVariable waitProd, waitConso;
-        unsigned nbWaitingProd, nbWaitingConso;
-
-    public:
-
-        BufferN(unsigned int size) : elements(size), writePointer(0),
-                                        readPointer(0), nbElements(0),
-                                        bufferSize(size),
-                                        nbWaitingProd(0), nbWaitingConso(0) {
-           }
-
-        void put(T item) {
-            mutex.lock();
-            if (nbElements == bufferSize) {
-                nbWaitingProd += 1;
-                waitProd.wait(&mutex);
-            }
-            elements[writePointer] = item;
-            writePointer = (writePointer + 1)
-                           % bufferSize;
-            nbElements ++;
-            if (nbWaitingConso > 0) {
-                nbWaitingConso -= 1;
-                waitConso.notifyOne();
-            }
-            mutex.unlock();
-        }
-
-        T get(void) {
-            T item;
-            mutex.lock();
-            if (nbElements == 0) {
-                nbWaitingConso += 1;
-                waitConso.wait(&mutex);
-            }
-            item = elements[readPointer];
-            readPointer = (readPointer + 1)
-                          % bufferSize;
-            nbElements --;
-            if (nbWaitingProd > 0) {
-                nbWaitingProd -= 1;
-                waitProd.notifyOne();
-            }
-            mutex.unlock();
-            return item;
-        }
-    };
-
-
-    template<typename T> class BufferNTime {
-    protected:
-        std::vector<T> elements;
-        int writePointer, readPointer, nbElements, bufferSize;
-        PcoMutex mutex;
-        PcoConditionVariable waitProd, waitConso;
-
-    public:
-
-        BufferNTime(unsigned int size) : elements(size), writePointer(0),
-                                        readPointer(0), nbElements(0),
-                                        bufferSize(size) {
-           }
-
-        int put(T item) {
-            mutex.lock();
-            auto nextPointer = (writePointer + 1) % bufferSize;
-            if (nbElements == bufferSize) {
-                waitProd.waitForSeconds(&mutex, 1);
-            }
-            if (nextPointer != readPointer) {
-                elements[writePointer] = item;
-                writePointer = (writePointer + 1)
-                               % bufferSize;
-                nbElements ++;
-                waitConso.notifyOne();
-                nextPointer = 1;
-            }
-            else {
-                nextPointer = 0;
-            }
-            mutex.unlock();
-            return nextPointer;
-        }
-
-        T get(void) {
-            T item;
-            mutex.lock();
-            if (nbElements == 0) {
-                waitConso.wait(&mutex);
-            }
-            item = elements[readPointer];
-            readPointer = (readPointer + 1)
-                          % bufferSize;
-            nbElements --;
-            waitProd.notifyOne();
-            mutex.unlock();
-            return item;
-        }
-    };
+    void pressKey(KEY_STATE key);
 
+    /** Réveille les threads du gestionnaire pour qu'ils se terminent */
+    void quit();
 
     static constexpr size_t MAXCOINS = 4;
-    BufferN<ARTICLE> bufferArticleIntroduction{1};
-    BufferNTime<COIN> bufferCoinsIntroduction{MAXCOINS};
+    // Un seul producteur (processKey) et un seul consommateur par canal
+    BlockingSpscRing<ARTICLE, 1> bufferArticleIntroduction;
+    BlockingSpscRing<COIN, MAXCOINS> bufferCoinsIntroduction;
 
     std::unique_ptr<PcoThread> threadButton;
 
@@ -260,6 +186,12 @@ protected:
 
     PcoMutex m_mutex;
 
+    // Dernière touche pressée, protégée par m_keyMutex. m_keyPressed est
+    // signalée à chaque touche et lors de l'arrêt du programme.
+    KEY_STATE m_keyState{KEY_UNDEFINED};
+    PcoMutex m_keyMutex;
+    PcoConditionVariable m_keyPressed;
+
     int m_accStatus{0};
     bool isNewAcc;
 
@@ -1,6 +1,8 @@
 #ifndef MACHINEINTERFACE_H
 #define MACHINEINTERFACE_H
 
+#include <array>
+#include <cstddef>
 #include <vector>
 
 /** Type des différentes pièces de monnaie, une valeur dans 1..9. */
@@ -59,6 +61,15 @@ public:
     */
     virtual void ejectArticle(ARTICLE article) = 0;
 
+    /** ejectPurchase: Réserve ensemble un article et les pièces du rendu,
+    * puis les éjecte. Si l'article ou l'une des pièces manque, rien n'est
+    * éjecté ni retiré de l'inventaire.
+    * Paramètres: l'article acheté et le nombre de pièces de chaque valeur
+    * à rendre.
+    * Valeur retournée: true si l'achat a été éjecté.
+    */
+    virtual bool ejectPurchase(ARTICLE article, const std::array<int, 9>& rendu) = 0;
+
     /** getInventoryArticle: Retourne le nombre d'items d'un article donné
     * encore disponibles dans la machine.
     * Paramètre: l'article dont on souhaite connaître le nombre restant.
@@ -86,10 +97,21 @@ public:
     * Si aucun compte n'est ouvert cette fonction n'a aucun effet. Sinon la
     * somme (positive ou négative) est additionnée au compte. Si la somme à
     * déduire est supérieure au solde du compte, le compte est mis à zéro.
-    * Valeur retournée: la somme restant sur le compte après sa modification.
+    * La vérification du compte ouvert et sa modification sont atomiques: un
+    * compte fermé entre les deux n'est jamais modifié.
+    * Valeur retournée: la somme restant sur le compte après sa modification,
+    * -1 si aucun compte n'est ouvert.
     */
     virtual int updateOpenAccount(int amount) = 0;
 
+    /** debitOpenAccount: Débite le compte ouvert uniquement si son solde
+    * suffit. La vérification et le débit sont atomiques: deux achats
+    * concurrents ne peuvent pas dépenser le même crédit.
+    * Valeur retournée: la somme restant sur le compte après le débit, -1 si
+    * aucun compte n'est ouvert ou si le solde est insuffisant.
+    */
+    virtual int debitOpenAccount(int amount) = 0;
+
     /** getKeyState: Retourne la derniere touche lue parmi les touches '&'
     * et '/'.
     * Valeur retournee: une valeur dans l'ensemble {KEY_YES,KEY_NO,
@@ -97,6 +119,15 @@ public:
     */
     virtual KEY_STATE getKeyState() = 0;
 
+    /** waitKey: Attente bloquante jusqu'à ce que l'une des touches '&' ou
+    * '/' soit pressée, au plus timeoutSeconds secondes. Retourne
+    * immédiatement si une touche a déjà été pressée depuis le dernier appel
+    * à resetKeyFunction.
+    * Valeur retournée: KEY_YES ou KEY_NO, KEY_UNDEFINED si le délai a expiré
+    * ou si le programme doit se terminer.
+    */
+    virtual KEY_STATE waitKey(int timeoutSeconds) = 0;
+
     /** resetKeyFunction: Remise a zero de la memoire associee aux tou-
     * ches '&' et '/'. Suite a l'appel de cette procedure, la fonction
     * Machine_GetEtatTouche renvoie la valeur KEY_UNDEFINED.
@@ -9,12 +9,14 @@
 #ifndef MACHINEMANAGER_H
 #define MACHINEMANAGER_H
 
+#include <atomic>
 #include <iostream>
+#include <optional>
 
 #include <pcosynchro/pcothread.h>
-#include <pcosynchro/pcologger.h>
-#include <pcosynchro/pcomutex.h>
 
+#include "asynclogger.h"
+#include "changemaker.h"
 #include "machineinterface.h"
 
 class MachineManager
@@ -22,14 +24,25 @@ class MachineManager
     /** Prix des differents articles vendus par cette machine */
     const std::array<int, MAX_ARTICLES> prixArticles = {1,2,3,4};
 
-    // Solde entré avec des pièces sans utiliser de compte
-    int sommeIntroduite = 0;
+    // Solde entré avec des pièces sans utiliser de compte. Un achat le
+    // réserve entièrement par compare-and-swap, sans verrou: une pièce
+    // introduite pendant l'achat reste acquise pour le suivant.
+    std::atomic<int> sommeIntroduite{0};
 
-    // Permet de protéger la variable sommeIntroduite
-    PcoMutex mutexSomme;
+    // Table de rendu de monnaie, utilisée uniquement par le thread Merchandise
+    ChangeMaker changeMaker;
 
-    // Permet de protéger le crédit du compte
-    PcoMutex mutexCompte;
+    /** Délai laissé au client pour accepter un rendu non optimal */
+    static constexpr int KEY_TIMEOUT_SECONDS = 30;
+
+    // Achat dont le rendu n'est pas optimal, en attente de la réponse du client
+    struct PendingPurchase {
+        ARTICLE article;
+        std::array<int, 9> rendu;
+        // Solde réservé, restitué si l'achat est refusé
+        int reserve;
+    };
+    std::optional<PendingPurchase> pendingPurchase;
 
 public:
 
@@ -56,19 +69,28 @@ public:
                 break;
             }
 
-            // Ajout de la pièce au solde dans la machine ou du compte
-            if (machine.isOpenAccount()) {
-                mutexCompte.lock();
-                logger() << "Pièce de " << coin << " ajoutée au compte." << std::endl;
-                machine.updateOpenAccount(coin);
-                logger() << "Solde disponible du compte: " << machine.getCreditOpenAccount() << std::endl;
-                mutexCompte.unlock();
-            } else {
-                mutexSomme.lock();
-                sommeIntroduite += coin;
-                logger() << "Solde disponible: " << sommeIntroduite << std::endl;
-                mutexSomme.unlock();
-            }
+            onCoin(coin);
+        }
+    }
+
+    /**
+     * Comptabilise une pièce reçue dans le compte ouvert ou dans le solde
+     * introduit. Appelé par Money, ou directement lorsque les événements
+     * sont distribués par un autre mécanisme (simulation de flotte).
+     * @param coin : pièce reçue
+     */
+    void onCoin(COIN coin)
+    {
+        // Ajout de la pièce au solde du compte ou dans la machine, le
+        // solde affiché est celui résultant de cet ajout. La présence d'un
+        // compte n'est pas testée à part: il pourrait être fermé entre le
+        // test et l'ajout, updateOpenAccount fait les deux d'un coup.
+        int solde = machine.updateOpenAccount(coin);
+        if (solde >= 0) {
+            LOG_INFO("Pièce de %d ajoutée au compte.\nSolde disponible du compte: %d", coin, solde);
+        } else {
+            solde = sommeIntroduite.fetch_add(coin) + coin;
+            LOG_INFO("Solde disponible: %d", solde);
         }
     }
 
@@ -84,8 +106,6 @@ public:
     void Merchandise()
     {
         ARTICLE article;     // Article voulu par le client
-        int prixArticle;
-        bool soldeInsuffisant;
 
         while (1) {
             article = machine.getArticle();   // lecture du souhait du client
@@ -95,154 +115,126 @@ public:
                 break;
             }
 
-            // Article non disponible
-            if (machine.getInventoryArticle(article) <= 0) {
-                logger() << std::endl;
-                logger() << "Article plus disponible. Veuillez choisir un autre article." << std::endl;
-                continue;
-            }
-
-            prixArticle = prixArticles[article];
-
-            // Vérification du solde inséré dans la machine ou du compte
-            mutexCompte.lock();
-            soldeInsuffisant = machine.isOpenAccount() && prixArticle > machine.getCreditOpenAccount();
-            mutexCompte.unlock();
+            onArticle(article);
 
-            mutexSomme.lock();
-            soldeInsuffisant = soldeInsuffisant || (!machine.isOpenAccount() && prixArticle > sommeIntroduite);
-            mutexSomme.unlock();
-
-            if (soldeInsuffisant) {
-                logger() << std::endl;
-                logger() << "Solde insuffisant pour cet article." << std::endl;
-                continue;
+            // Rendu non optimal: le thread dort jusqu'à la réponse du client
+            if (pendingPurchase) {
+                onKey(machine.waitKey(KEY_TIMEOUT_SECONDS));
             }
-
-            logger() << "[Marchandise]" << std::endl;
-            logger() << "Article selectionné : " << std::endl;
-            displayArticle(article);
-            logger() << std::endl;
-
-            // Achat de l'article
-            if (machine.isOpenAccount()) {
-                acheterArticleAvecCompte(article, prixArticle);
-            } else {
-                acheterArticleSansCompte(article, prixArticle);
-            }
-
         } // fin de la boucle infinie
     }
 
-
     /**
-     * Calcul la monnaie à rendre en fonction du amount
-     * à rendre et des pièces disponibles dans la machine.
-     * Paramètres :
-     * - const uint aRendre         Valeur du amount à rendre
-     * - std::array<int, 9>& rendu  Tableau contenant les pièces à rendre (retour)
-     * - uint* renduTot             Valeur de rendu possible (retour)
-     * Retourne vrai si un rendu optimal est possible
+     * Traite le choix d'un article par le client: vérifie sa disponibilité
+     * et le solde, puis effectue l'achat.
+     * @param article : article choisi
      */
-    bool amountToReturn(int aRendre, std::array<int, 9>& rendu, int& renduTot){
+    void onArticle(ARTICLE article)
+    {
+        int prixArticle;
 
-        //On crée un tableau temporaire pour l'algorithme, toutes les cases étant initialisées
-        // à 0
-        std::vector<uint> tabTemp(aRendre+1, 0);
-        //On clean le tableau reçu en paramètre des pièces à rendre
-        for (int i = 0; i < 9 ; i++) {
-            rendu[i] = 0;
+        // Un nouveau choix remplace l'achat encore en attente de confirmation
+        if (pendingPurchase) {
+            LOG_INFO("Achat précédent annulé.");
+            annulerAchatEnAttente();
         }
 
-        // Algorithme : remplissage du tableau temporaire
-
-        //On parcourt tout les types de pièces de la plus grande
-        //(ou valeur à rendre si plus petit) à la plus petite
-        for(int i = aRendre<9?aRendre:9 ; i>0 ; i--) {
-            // Pour toutes les pièces en stock d'une valeur donnée
-            for (uint j = 0 ; j<machine.getInventoryCoin(i) ; j++) {
-                // On parcourt et remplit le tableau temporaire de l'algorithme
-                // (on s'arrête lorsqu'on à dépassé l'indice de la valeur de la
-                // pièce en cours)
-                for(int k = aRendre ; k>=i ; k--) {
-
-                    /* On place la pièce dans le tableau si les conditions sont remplies :
-                         - si l'emplacement actuel et vide et
-                                - si i cases avant il y a déjà une pièce ou
-                            si l'indice courant = la valeur de la pièce */
-                    if( tabTemp[k] == 0 && ( tabTemp[k-i] != 0 || k == i )) {
-                        tabTemp[k] = i;
-                        break;
-                    }
-                }
-            }
+        // Article non disponible
+        if (machine.getInventoryArticle(article) <= 0) {
+            LOG_INFO("\nArticle plus disponible. Veuillez choisir un autre article.");
+            return;
         }
 
-        // Préparation du tableau à retourner
+        prixArticle = prixArticles[article];
 
-        //On part depuis la fin du tableau temporaire
-        int indice = aRendre;
-        int somme = 0;
-        int coin;
+        // Achat de l'article, le solde est vérifié et réservé atomiquement
+        if (machine.isOpenAccount()) {
+            acheterArticleAvecCompte(article, prixArticle);
+        } else {
+            acheterArticleSansCompte(article, prixArticle);
+        }
+    }
 
-        //Tant qu'on est pas arrivé au début du tableau temporaire
-        while(indice > 0) {
-            /*S'il y a une pièce à l'indice en cours on la prend et on décrèmente
-              l'indice de la valeur de la pièce. sinon on descend dans la tableau
-                jusqu'à tomber sur une pièce */
-            if(tabTemp[indice] != 0) {
-                coin = tabTemp[indice];
 
-                somme += coin;
-                rendu[coin-1]++;
-                indice -= coin;
+    /**
+     * Traite la réponse du client à la proposition d'un rendu non optimal.
+     * Sans achat en attente, la touche est ignorée.
+     * @param key : touche pressée, KEY_UNDEFINED si le délai a expiré
+     */
+    void onKey(KEY_STATE key)
+    {
+        if (!pendingPurchase) {
+            return;
+        }
+
+        switch (key) {
+        case KEY_YES:
+            LOG_INFO("Achat confirmé.");
+            // L'inventaire a pu changer depuis la proposition
+            if (!acheterArticle(pendingPurchase->article, pendingPurchase->rendu)) {
+                annulerAchatEnAttente();
+                break;
             }
-            else
-                indice--;
+            pendingPurchase.reset();
+            // On reset le choix de l'utilisateur afin qu'il puisse changer d'avis lors du
+            // prochain achat.
+            machine.resetKeyFunction();
+            break;
+        case KEY_NO:
+            LOG_INFO("Achat annulé.");
+            annulerAchatEnAttente();
+            break;
+        default:
+            LOG_INFO("Pas de réponse, achat annulé.");
+            annulerAchatEnAttente();
+            break;
         }
+    }
 
-        // Retourne le tableau des pièces à rendre, on indique si on peut rendre juste
-        return (renduTot = somme) == aRendre;
+    /**
+     * Calcul la monnaie à rendre en fonction du amount
+     * à rendre et des pièces disponibles dans la machine.
+     * L'inventaire n'est relu qu'une fois par appel, la table de rendu
+     * n'étant recalculée que pour les pièces dont le nombre a changé.
+     * Paramètres :
+     * - int aRendre                Valeur du montant à rendre
+     * - std::array<int, 9>& rendu  Tableau contenant les pièces à rendre (retour)
+     * - int& renduTot              Valeur de rendu possible (retour)
+     * Retourne vrai si un rendu exact est possible, le nombre de pièces
+     * rendues étant toujours minimal
+     */
+    bool amountToReturn(int aRendre, std::array<int, 9>& rendu, int& renduTot){
+        changeMaker.update(machine);
+        return changeMaker.change(aRendre, rendu, renduTot);
     }
 
 
     void displayArticle(ARTICLE article)
     {
         switch (article) {
-        case CHOCOLATE: logger() << "Chocolate " << std::endl; break;
-        case CANDYCANE: logger() << "Candy cane " << std::endl; break;
-        case GUMMYBEAR: logger() << "Gummy bear " << std::endl; break;
-        case LOLLIPOP: logger() << "Lollipop " << std::endl; break;
-        default: logger() << "Error, unexisting article " << std::endl; break;
+        case CHOCOLATE: LOG_INFO("Chocolate "); break;
+        case CANDYCANE: LOG_INFO("Candy cane "); break;
+        case GUMMYBEAR: LOG_INFO("Gummy bear "); break;
+        case LOLLIPOP: LOG_INFO("Lollipop "); break;
+        default: LOG_ERROR("Error, unexisting article "); break;
         }
     }
 
     /**
-     * Ejecte l'article acheté et affiche un petit message de succès
+     * Ejecte l'article acheté avec sa monnaie et affiche un petit message
+     * de succès. Article et pièces sont réservés ensemble: si l'un manque,
+     * rien n'est éjecté.
      * @param article : Article à acheter
+     * @param rendu : pièces à rendre
+     * @return true si l'achat a été éjecté
      */
-    void acheterArticle(ARTICLE article) {
-        machine.ejectArticle(article);
-        logger() << "Article acheté avec succès." << std::endl;
-    }
-
-    /**
-     * Sort de la machines les différentes pièces à rendre
-     * @param rendu: pièces à rendre
-     */
-    void rendreMoney(const std::array<int, 9>& rendu) {
-        COIN coin;
-
-        for (size_t i = 0; i < rendu.size(); ++i ) {
-            for (int j = 0; j < rendu[i]; ++j ) {
-                coin = i + 1;
-                machine.ejectCoin(coin);
-            }
+    bool acheterArticle(ARTICLE article, const std::array<int, 9>& rendu) {
+        if (!machine.ejectPurchase(article, rendu)) {
+            LOG_INFO("Article ou monnaie plus disponible, achat annulé.");
+            return false;
         }
-        // Le solde courant introduit passe à 0
-        mutexSomme.lock();
-        sommeIntroduite = 0;
-        mutexSomme.unlock();
+        LOG_INFO("Article acheté avec succès.");
+        return true;
     }
 
     /**
@@ -251,15 +243,23 @@ public:
      * @param prixArticle : prix de l'article souhaité
      */
     void acheterArticleAvecCompte(ARTICLE article, int prixArticle) {
-        acheterArticle(article);
-        mutexCompte.lock();
-        machine.updateOpenAccount(-prixArticle);
-        logger() << "Solde restant du compte: " << machine.getCreditOpenAccount() << std::endl;
-        mutexCompte.unlock();
+        int soldeRestant = machine.debitOpenAccount(prixArticle);
+        if (soldeRestant < 0) {
+            soldeInsuffisant();
+            return;
+        }
+
+        afficherSelection(article);
+        if (!acheterArticle(article, {})) {
+            soldeRestant = machine.updateOpenAccount(prixArticle);
+        }
+        LOG_INFO("Solde restant du compte: %d", soldeRestant);
     }
 
     /**
-     * Achète l'article souhaité avec système de rendu de monnaie
+     * Achète l'article souhaité avec système de rendu de monnaie. Si le
+     * rendu n'est pas optimal, l'achat est mis en attente de la réponse du
+     * client, traitée par onKey.
      * @param article : article souhaité
      * @param prixArticle : prix de l'article souhaité
      */
@@ -268,51 +268,59 @@ public:
         int valeurRendue;
         int valeurAttendue;
         bool retourOptimal;
-        bool entreeUtilisateur;
+        int reserve;
+
+        // Réserve tout le solde introduit, la différence avec le prix étant rendue
+        reserve = sommeIntroduite.load();
+        do {
+            if (reserve < prixArticle) {
+                soldeInsuffisant();
+                return;
+            }
+        } while (!sommeIntroduite.compare_exchange_weak(reserve, 0));
+
+        afficherSelection(article);
 
-        mutexSomme.lock();
-        valeurAttendue = sommeIntroduite - prixArticle;
-        mutexSomme.unlock();
+        valeurAttendue = reserve - prixArticle;
         retourOptimal = amountToReturn(valeurAttendue, rendu, valeurRendue);
 
         if (retourOptimal) {
-            acheterArticle(article);
-            rendreMoney(rendu);
+            if (!acheterArticle(article, rendu)) {
+                int solde = sommeIntroduite.fetch_add(reserve) + reserve;
+                LOG_INFO("Solde disponible: %d", solde);
+            }
             return;
         }
 
         // Rendu non optimal, l'utilisateur a le choix d'accepter ou non
 
-        logger() << "Rendu de votre monnaie non optimal: " << std::endl
-                 << "Valeur rendue: " << valeurRendue << " / "
-                 << "Valeur attendue: " << valeurAttendue << std::endl
-                 << "Acceptez-vous [&/] ?" << std::endl;
+        LOG_INFO("Rendu de votre monnaie non optimal: \nValeur rendue: %d / Valeur attendue: %d\nAcceptez-vous [&/] ?",
+                 valeurRendue, valeurAttendue);
 
-        entreeUtilisateur = false;
-        do {
-            switch (machine.getKeyState()) { // lire la touche fonction
-            case KEY_YES:
-                logger() << "Achat confirmé." << std::endl;
-                acheterArticle(article);
-                rendreMoney(rendu);
-                entreeUtilisateur = true;
-                break;
-            case KEY_NO:
-                logger() << "Achat annulé." << std::endl;
-                entreeUtilisateur = true;
-                break;
-            default:
-                // Attente active ici
-                break;
-            }
-        } while (!entreeUtilisateur);
-        // On reset le choix de l'utilisateur afin qu'il puisse changer d'avis lors du
-        // prochain achat.
-        machine.resetKeyFunction();
+        pendingPurchase = PendingPurchase{article, rendu, reserve};
     }
 
 private:
 
+    void soldeInsuffisant() {
+        LOG_INFO("\nSolde insuffisant pour cet article.");
+    }
+
+    void afficherSelection(ARTICLE article) {
+        LOG_INFO("[Marchandise]\nArticle selectionné : ");
+        displayArticle(article);
+    }
+
+    /**
+     * Abandonne l'achat en attente et restitue le solde qu'il avait réservé
+     */
+    void annulerAchatEnAttente() {
+        int solde = sommeIntroduite.fetch_add(pendingPurchase->reserve) + pendingPurchase->reserve;
+        pendingPurchase.reset();
+        machine.resetKeyFunction();
+        LOG_INFO("Solde disponible: %d", solde);
+    }
+
     MachineInterface &machine;
 };
 
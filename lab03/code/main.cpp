@@ -1,12 +1,71 @@
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <pcosynchro/pcothread.h>
 #include <pcosynchro/pcologger.h>
 
+#include "fleet.h"
 #include "machine.h"
 #include "machinemanager.h"
+#include "scriptedmachine.h"
 
-int main()
+int main(int argc, char *argv[])
 {
+    // --fleet [nbMachines] [nbThreads] [nbEvénementsParMachine]: simulation
+    // d'une flotte de machines, sans interface
+    if (argc > 1 && strcmp(argv[1], "--fleet") == 0) {
+        size_t nbMachines = argc > 2 ? strtoul(argv[2], nullptr, 10) : 10000;
+        size_t nbWorkers = argc > 3 ? strtoul(argv[3], nullptr, 10) : 4;
+        size_t nbEvents = argc > 4 ? strtoul(argv[4], nullptr, 10) : 100;
+        if (nbWorkers < 1) {
+            logger() << "La flotte doit avoir au moins un thread de travail" << std::endl;
+            return EXIT_FAILURE;
+        }
+        return runFleetSimulation(nbMachines, nbWorkers, nbEvents);
+    }
+
+    // --bench [nbEvénements] [événementsParSeconde] [graine] [trace] [inventaire]:
+    // banc d'essai de MachineManager sur un scénario aléatoire, 0 événement
+    // par seconde pour envoyer au plus vite. Le scénario est enregistré dans
+    // le fichier trace s'il est donné, l'inventaire est journalisé dans les
+    // fichiers inventaire.snap / .wal s'ils sont donnés.
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        size_t nbEvents = argc > 2 ? strtoul(argv[2], nullptr, 10) : 100000;
+        double rate = argc > 3 ? strtod(argv[3], nullptr) : 0;
+        uint32_t seed = argc > 4 ? strtoul(argv[4], nullptr, 10) : 42;
+        Script script = ScriptedMachine::generate(seed, nbEvents, rate);
+        if (argc > 5 && argv[5][0] != '\0' && !ScriptedMachine::saveTrace(script, argv[5])) {
+            logger() << "Impossible d'écrire la trace " << argv[5] << std::endl;
+            return EXIT_FAILURE;
+        }
+        ScriptedMachine::Options options;
+        options.respectTimestamps = rate > 0;
+        // Au débit maximal, seule une touche déjà envoyée répond à une
+        // demande de confirmation: la mesure n'inclut pas l'attente du client
+        if (rate <= 0) {
+            options.keyTimeoutMs = 0;
+        }
+        if (argc > 6) {
+            options.inventoryPath = argv[6];
+        }
+        return runMachineBenchmark(script, options);
+    }
+
+    // --replay trace: rejoue une trace événement par événement, les délais
+    // de confirmation comptés sur les dates de la trace. Les ventes et
+    // l'inventaire final sont identiques d'une exécution à l'autre
+    if (argc > 2 && strcmp(argv[1], "--replay") == 0) {
+        Script script;
+        if (!ScriptedMachine::loadTrace(argv[2], script)) {
+            logger() << "Trace invalide: " << argv[2] << std::endl;
+            return EXIT_FAILURE;
+        }
+        ScriptedMachine::Options options;
+        options.respectTimestamps = false;
+        options.lockstep = true;
+        return runMachineBenchmark(script, options);
+    }
+
     logger().setVerbosity(1);
 
     logger() << "Simulateur de machine\n"
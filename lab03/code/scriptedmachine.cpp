@@ -0,0 +1,434 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <thread>
+
+#include <pcosynchro/pcologger.h>
+
+#include "asynclogger.h"
+#include "machinemanager.h"
+#include "scriptedmachine.h"
+
+ScriptedMachine::ScriptedMachine(Script script, Options options)
+    : script(std::move(script)), options(options),
+      inventory({3,3,3,3,3,3,3,3,3}, {1000000,1000000,1000000,1000000})
+{
+    if (!options.inventoryPath.empty() && !inventory.open(options.inventoryPath)) {
+        LOG_ERROR("Inventaire non persistant: impossible d'ouvrir %s", options.inventoryPath.c_str());
+    }
+}
+
+ScriptedMachine::~ScriptedMachine()
+{
+    if (feeder) {
+        feeder->join();
+    }
+}
+
+int64_t ScriptedMachine::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Script ScriptedMachine::generate(uint32_t seed, size_t nbEvents, double eventsPerSecond)
+{
+    Script script;
+    script.reserve(nbEvents);
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> eventType(0, 99);
+    std::uniform_int_distribution<int> coin(1, 9);
+    std::uniform_int_distribution<int> article(0, MAX_ARTICLES - 1);
+    std::uniform_int_distribution<int> initialCredit(0, 20);
+    std::exponential_distribution<double> interval(eventsPerSecond > 0 ? eventsPerSecond : 1);
+
+    double time = 0;
+    bool accountOpen = false;
+    for (size_t i = 0; i < nbEvents; i++) {
+        if (eventsPerSecond > 0) {
+            time += interval(generator);
+        }
+        int type = eventType(generator);
+        FleetEvent event;
+        if (type < 55) {
+            event = {FleetEvent::COIN_INSERTED, coin(generator)};
+        } else if (type < 90) {
+            event = {FleetEvent::ARTICLE_SELECTED, article(generator)};
+        } else if (type < 96) {
+            event = {FleetEvent::KEY_PRESSED, type % 2 ? KEY_YES : KEY_NO};
+        } else if (!accountOpen) {
+            event = {FleetEvent::ACCOUNT_OPENED, initialCredit(generator)};
+            accountOpen = true;
+        } else {
+            event = {FleetEvent::ACCOUNT_CLOSED, 0};
+            accountOpen = false;
+        }
+        script.push_back({(int64_t)(time * 1e9), event});
+    }
+    return script;
+}
+
+bool ScriptedMachine::saveTrace(const Script &script, const std::string &path)
+{
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file << "# temps_ns type valeur\n";
+    for (const ScriptedEvent &scripted : script) {
+        file << scripted.timeNs << ' ' << scripted.event.type << ' ' << scripted.event.value << '\n';
+    }
+    return (bool)file.flush();
+}
+
+bool ScriptedMachine::loadTrace(const std::string &path, Script &script)
+{
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        ScriptedEvent scripted;
+        int type;
+        if (sscanf(line.c_str(), "%lld %d %d", (long long *)&scripted.timeNs, &type, &scripted.event.value) != 3
+                || type < FleetEvent::COIN_INSERTED || type > FleetEvent::ACCOUNT_CLOSED) {
+            return false;
+        }
+        scripted.event.type = (FleetEvent::Type)type;
+        script.push_back(scripted);
+    }
+    return true;
+}
+
+int ScriptedMachine::initialize()
+{
+    feeder = std::make_unique<PcoThread>(&ScriptedMachine::feederRun, this);
+    return 1;
+}
+
+void ScriptedMachine::injected()
+{
+    progressMutex.lock();
+    nbInjected++;
+    progressMutex.unlock();
+}
+
+void ScriptedMachine::completed(int64_t scheduledNs, std::vector<int64_t> &latencies)
+{
+    latencies.push_back(now() - scheduledNs);
+    progressMutex.lock();
+    nbCompleted++;
+    progressCond.notifyOne();
+    progressMutex.unlock();
+}
+
+void ScriptedMachine::finished()
+{
+    progressMutex.lock();
+    nbCompleted++;
+    progressCond.notifyOne();
+    progressMutex.unlock();
+}
+
+void ScriptedMachine::waitCompleted()
+{
+    progressMutex.lock();
+    while (nbCompleted < nbInjected) {
+        progressCond.wait(&progressMutex);
+    }
+    progressMutex.unlock();
+}
+
+void ScriptedMachine::expireKeyWait(const ScriptedEvent &next)
+{
+    std::unique_lock<std::mutex> lock(keyMutex);
+    if (!waitingKey) {
+        return;
+    }
+    bool expired = next.timeNs - articleScriptNs > (int64_t)options.keyTimeoutMs * 1000000;
+    // Un article n'est lu qu'après la réponse: la demande expire avant
+    if (!expired && next.event.type != FleetEvent::ARTICLE_SELECTED) {
+        return;
+    }
+    injected();
+    keyExpired = true;
+    keyPressed.notify_all();
+    lock.unlock();
+    waitCompleted();
+}
+
+void ScriptedMachine::feederRun()
+{
+    startNs = now();
+    for (const ScriptedEvent &scripted : script) {
+        if (options.lockstep) {
+            waitCompleted();
+            expireKeyWait(scripted);
+        }
+
+        int64_t scheduled = startNs + scripted.timeNs;
+        if (options.respectTimestamps && scheduled > now()) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(scheduled - now()));
+        } else if (!options.respectTimestamps) {
+            scheduled = now();
+        }
+
+        const FleetEvent &event = scripted.event;
+        switch (event.type) {
+        case FleetEvent::COIN_INSERTED:
+            // Une pièce que l'inventaire ne peut pas enregistrer est rendue
+            if (!inventory.addCoin(event.value)) {
+                break;
+            }
+            injected();
+            coins.put({event.value, scheduled});
+            break;
+        case FleetEvent::ARTICLE_SELECTED:
+            injected();
+            articleScriptNs = scripted.timeNs;
+            articles.put({(ARTICLE)event.value, scheduled});
+            break;
+        case FleetEvent::KEY_PRESSED: {
+            std::lock_guard<std::mutex> lock(keyMutex);
+            // La réponse sera traitée avant l'événement suivant
+            if (waitingKey) {
+                injected();
+            }
+            keyState = (KEY_STATE)event.value;
+            keyPressed.notify_all();
+            break;
+        }
+        case FleetEvent::ACCOUNT_OPENED:
+            credit = event.value;
+            break;
+        case FleetEvent::ACCOUNT_CLOSED:
+            credit = NO_ACCOUNT;
+            break;
+        }
+    }
+
+    waitCompleted();
+    endNs = now();
+
+    // Les deux threads du gestionnaire attendent un événement: ils sont
+    // réveillés par une dernière valeur et constatent la fin du scénario
+    {
+        std::lock_guard<std::mutex> lock(keyMutex);
+        quit = true;
+        keyPressed.notify_all();
+    }
+    coins.put({0, 0});
+    articles.put({CHOCOLATE, 0});
+}
+
+COIN ScriptedMachine::getCoin()
+{
+    // Money redemande une pièce: la précédente est entièrement traitée
+    if (coinInFlight) {
+        completed(coinScheduled, coinLatencies);
+    }
+    Timed<COIN> coin = coins.get();
+    coinInFlight = !quit;
+    coinScheduled = coin.scheduledNs;
+    return coin.value;
+}
+
+ARTICLE ScriptedMachine::getArticle()
+{
+    if (articleInFlight) {
+        completed(articleScheduled, articleLatencies);
+    }
+    // La réponse à la demande de confirmation a été traitée par onKey
+    if (keyInFlight) {
+        finished();
+        keyInFlight = false;
+    }
+    Timed<ARTICLE> article = articles.get();
+    articleInFlight = !quit;
+    articleScheduled = article.scheduledNs;
+    return article.value;
+}
+
+void ScriptedMachine::ejectCoin(COIN coin)
+{
+    if (coin > 0 && coin <= 9) {
+        inventory.takeCoin(coin);
+    }
+}
+
+void ScriptedMachine::ejectArticle(ARTICLE article)
+{
+    if (inventory.takeArticle(article)) {
+        nbArticlesSold++;
+    }
+}
+
+bool ScriptedMachine::ejectPurchase(ARTICLE article, const std::array<int, 9>& rendu)
+{
+    if (!inventory.reservePurchase(article, rendu)) {
+        return false;
+    }
+    nbArticlesSold++;
+    return true;
+}
+
+unsigned ScriptedMachine::getInventoryArticle(ARTICLE article)
+{
+    return inventory.getArticle(article);
+}
+
+unsigned ScriptedMachine::getInventoryCoin(COIN coin)
+{
+    return inventory.getCoin(coin);
+}
+
+bool ScriptedMachine::isOpenAccount()
+{
+    return credit.load() != NO_ACCOUNT;
+}
+
+int ScriptedMachine::getCreditOpenAccount()
+{
+    return credit.load();
+}
+
+int ScriptedMachine::updateOpenAccount(int amount)
+{
+    // Le compte est fermé si le compare-and-swap voit NO_ACCOUNT: la
+    // vérification et la modification ne font qu'une opération
+    int current = credit.load();
+    int result;
+    do {
+        if (current == NO_ACCOUNT) {
+            return -1;
+        }
+        result = current + amount >= 0 ? current + amount : 0;
+    } while (!credit.compare_exchange_weak(current, result));
+    return result;
+}
+
+int ScriptedMachine::debitOpenAccount(int amount)
+{
+    int current = credit.load();
+    do {
+        if (current == NO_ACCOUNT || current < amount) {
+            return -1;
+        }
+    } while (!credit.compare_exchange_weak(current, current - amount));
+    return current - amount;
+}
+
+KEY_STATE ScriptedMachine::getKeyState()
+{
+    std::lock_guard<std::mutex> lock(keyMutex);
+    return keyState;
+}
+
+KEY_STATE ScriptedMachine::waitKey(int timeoutSeconds)
+{
+    if (options.lockstep) {
+        std::unique_lock<std::mutex> lock(keyMutex);
+        // Une touche déjà pressée répond sans attendre: l'article ne sera
+        // terminé qu'une fois la réponse traitée, au prochain getArticle
+        if (keyState != KEY_UNDEFINED || quit) {
+            return keyState;
+        }
+        waitingKey = true;
+        keyExpired = false;
+        lock.unlock();
+        // Le scénario peut envoyer l'événement suivant, qui répond à la
+        // demande, la fait expirer ou est traité par Money pendant l'attente
+        completed(articleScheduled, articleLatencies);
+        articleInFlight = false;
+        lock.lock();
+        keyPressed.wait(lock, [this] {
+            return keyState != KEY_UNDEFINED || keyExpired || quit;
+        });
+        waitingKey = false;
+        keyInFlight = !quit;
+        return keyState;
+    }
+
+    // L'article attend maintenant le client: son traitement par la machine
+    // est terminé, ce qui permet au scénario d'envoyer la réponse
+    if (articleInFlight) {
+        completed(articleScheduled, articleLatencies);
+        articleInFlight = false;
+    }
+
+    int timeoutMs = std::min(timeoutSeconds * 1000, options.keyTimeoutMs);
+    std::unique_lock<std::mutex> lock(keyMutex);
+    keyPressed.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] {
+        return keyState != KEY_UNDEFINED || quit;
+    });
+    return keyState;
+}
+
+void ScriptedMachine::resetKeyFunction()
+{
+    std::lock_guard<std::mutex> lock(keyMutex);
+    keyState = KEY_UNDEFINED;
+}
+
+bool ScriptedMachine::shouldQuit()
+{
+    return quit;
+}
+
+ScriptedMachine::Stats ScriptedMachine::getStats()
+{
+    Stats stats;
+    stats.nbEvents = script.size();
+    stats.nbArticlesSold = nbArticlesSold;
+    stats.seconds = (endNs - startNs) / 1e9;
+    for (int i = 0; i < Inventory::NB_COINS; i++) {
+        stats.coins[i] = inventory.getCoin(i + 1);
+    }
+    for (size_t i = 0; i < MAX_ARTICLES; i++) {
+        stats.articles[i] = inventory.getArticle((ARTICLE)i);
+    }
+
+    std::vector<int64_t> latencies(coinLatencies);
+    latencies.insert(latencies.end(), articleLatencies.begin(), articleLatencies.end());
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        stats.p50Ns = latencies[latencies.size() / 2];
+        stats.p99Ns = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+        stats.maxNs = latencies.back();
+    }
+    return stats;
+}
+
+
+ScriptedMachine::Stats runMachineScript(const Script &script, const ScriptedMachine::Options &options)
+{
+    ScriptedMachine machine(script, options);
+    MachineManager manager(machine);
+    machine.initialize();
+    PcoThread threadMoney(&MachineManager::Money, &manager);
+    PcoThread threadMerchandise(&MachineManager::Merchandise, &manager);
+    threadMoney.join();
+    threadMerchandise.join();
+    return machine.getStats();
+}
+
+int runMachineBenchmark(const Script &script, const ScriptedMachine::Options &options)
+{
+    // Seules les erreurs sont affichées pendant la mesure
+    AsyncLogger::instance().setLevel(LOG_LEVEL_ERROR);
+    ScriptedMachine::Stats stats = runMachineScript(script, options);
+    AsyncLogger::instance().flush();
+    AsyncLogger::instance().setLevel(LOG_LEVEL);
+    logger() << "Événements: " << stats.nbEvents << " en " << stats.seconds << " s ("
+             << stats.nbEvents / stats.seconds << " événements/s)" << std::endl
+             << "Articles vendus: " << stats.nbArticlesSold << " ("
+             << stats.nbArticlesSold / stats.seconds << " transactions/s)" << std::endl
+             << "Latence p50: " << stats.p50Ns / 1e3 << " us, p99: " << stats.p99Ns / 1e3
+             << " us, max: " << stats.maxNs / 1e3 << " us" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,208 @@
+/**
+  \file scriptedmachine.h
+  \author Valentin Kaelin & Lazar Pavicevic
+  \date 19.10.2026
+  \brief Machine pilotée par un scénario d'événements.
+  Ce fichier déclare ScriptedMachine, une implémentation de MachineInterface
+  dont les pièces, articles, touches et comptes proviennent d'un scénario
+  généré à partir d'une graine ou relu depuis une trace, au lieu du clavier.
+  Elle mesure la latence de chaque événement traité par MachineManager et
+  sert de base au banc d'essai (--bench et --replay).
+*/
+
+#ifndef SCRIPTEDMACHINE_H
+#define SCRIPTEDMACHINE_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <pcosynchro/pcothread.h>
+#include <pcosynchro/pcomutex.h>
+#include <pcosynchro/pcoconditionvariable.h>
+
+#include "fleet.h"
+#include "inventory.h"
+#include "machineinterface.h"
+#include "spscring.h"
+
+/** Événement d'un scénario, daté depuis le début de celui-ci */
+struct ScriptedEvent {
+    int64_t timeNs;
+    FleetEvent event;
+};
+
+using Script = std::vector<ScriptedEvent>;
+
+class ScriptedMachine : public MachineInterface
+{
+public:
+    struct Options {
+        // Respecte les dates du scénario, sinon les événements sont envoyés
+        // aussi vite que la machine les accepte
+        bool respectTimestamps = true;
+        // Attend la fin du traitement de chaque événement avant d'envoyer
+        // le suivant, y compris la réponse à une demande de confirmation:
+        // Money et Merchandise ne traitent jamais deux événements à la fois
+        // et l'état final ne dépend que du scénario
+        bool lockstep = false;
+        // Délai de réponse du client simulé à une demande de confirmation,
+        // remplace le délai demandé par MachineManager. Mesuré en temps
+        // réel, sauf en mode lockstep où il est compté sur les dates du
+        // scénario: une demande expire au premier événement plus tardif que
+        // ce délai, ou au choix d'un nouvel article
+        int keyTimeoutMs = 100;
+        // Journalise l'inventaire dans ces fichiers, en mémoire si vide
+        std::string inventoryPath;
+    };
+
+    struct Stats {
+        uint64_t nbEvents = 0;
+        uint64_t nbArticlesSold = 0;
+        double seconds = 0;
+        // Latences des pièces et articles, de leur date prévue à la fin de
+        // leur traitement
+        int64_t p50Ns = 0;
+        int64_t p99Ns = 0;
+        int64_t maxNs = 0;
+        // Inventaire final
+        Inventory::Coins coins{};
+        Inventory::Articles articles{};
+    };
+
+    ScriptedMachine(Script script, Options options);
+
+    /** Attend la fin de l'envoi du scénario */
+    ~ScriptedMachine();
+
+    /**
+     * Génère un scénario aléatoire reproductible.
+     * \param seed graine du générateur
+     * \param nbEvents nombre d'événements
+     * \param eventsPerSecond débit moyen, arrivées de Poisson; 0 pour dater
+     *        tous les événements à l'instant initial
+     */
+    static Script generate(uint32_t seed, size_t nbEvents, double eventsPerSecond);
+
+    /** Écrit un scénario, une ligne "temps_ns type valeur" par événement */
+    static bool saveTrace(const Script &script, const std::string &path);
+
+    /** Lit un scénario écrit par saveTrace */
+    static bool loadTrace(const std::string &path, Script &script);
+
+    /** Démarre l'envoi du scénario. \return 1 */
+    int initialize() override;
+
+    COIN getCoin() override;
+    ARTICLE getArticle() override;
+    void ejectCoin(COIN coin) override;
+    void ejectArticle(ARTICLE article) override;
+    bool ejectPurchase(ARTICLE article, const std::array<int, 9>& rendu) override;
+    unsigned getInventoryArticle(ARTICLE article) override;
+    unsigned getInventoryCoin(COIN coin) override;
+    bool isOpenAccount() override;
+    int getCreditOpenAccount() override;
+    int updateOpenAccount(int amount) override;
+    int debitOpenAccount(int amount) override;
+    KEY_STATE getKeyState() override;
+    KEY_STATE waitKey(int timeoutSeconds) override;
+    void resetKeyFunction() override;
+
+    /** Vrai une fois tous les événements du scénario traités */
+    bool shouldQuit() override;
+
+    /** Statistiques, à lire une fois Money et Merchandise terminés */
+    Stats getStats();
+
+private:
+    // Événement transmis au gestionnaire avec sa date prévue
+    template<typename T>
+    struct Timed {
+        T value;
+        int64_t scheduledNs;
+    };
+
+    static int64_t now();
+
+    void feederRun();
+
+    /** Un événement de plus a été envoyé au gestionnaire */
+    void injected();
+
+    /** Un événement de plus a été traité, prévu à scheduledNs */
+    void completed(int64_t scheduledNs, std::vector<int64_t> &latencies);
+
+    /** Un événement de plus a été traité, sans mesure de latence */
+    void finished();
+
+    /** Attend que tous les événements envoyés aient été traités */
+    void waitCompleted();
+
+    /**
+     * En mode lockstep, fait expirer la demande de confirmation en cours si
+     * l'événement suivant du scénario ne peut pas y répondre, et attend la
+     * fin de son traitement.
+     */
+    void expireKeyWait(const ScriptedEvent &next);
+
+    Script script;
+    Options options;
+
+    // Un seul producteur (feederRun) et un seul consommateur par canal
+    BlockingSpscRing<Timed<COIN>, 64> coins;
+    BlockingSpscRing<Timed<ARTICLE>, 64> articles;
+
+    // Événement rendu par getCoin / getArticle et pas encore terminé,
+    // accédés uniquement par le thread consommateur correspondant
+    bool coinInFlight{false}, articleInFlight{false}, keyInFlight{false};
+    int64_t coinScheduled{0}, articleScheduled{0};
+    // Date dans le scénario du dernier article envoyé, propre à feederRun
+    int64_t articleScriptNs{0};
+    std::vector<int64_t> coinLatencies, articleLatencies;
+
+    PcoMutex progressMutex;
+    PcoConditionVariable progressCond;
+    uint64_t nbInjected{0}, nbCompleted{0};
+
+    Inventory inventory;
+    std::atomic<uint64_t> nbArticlesSold{0};
+
+    // Solde du compte ouvert, NO_ACCOUNT si aucun: l'état du compte tient
+    // dans un seul mot, modifié par compare-and-swap
+    static constexpr int NO_ACCOUNT = -1;
+    std::atomic<int> credit{NO_ACCOUNT};
+
+    // Les délais du client simulé sont en millisecondes, d'où une variable
+    // de condition standard plutôt que PcoConditionVariable
+    std::mutex keyMutex;
+    std::condition_variable keyPressed;
+    KEY_STATE keyState{KEY_UNDEFINED};
+    // Mode lockstep: Merchandise attend une touche, que le scénario fournit
+    // ou fait expirer
+    bool waitingKey{false};
+    bool keyExpired{false};
+
+    std::atomic<bool> quit{false};
+    int64_t startNs{0}, endNs{0};
+    std::unique_ptr<PcoThread> feeder;
+};
+
+/**
+ * Exécute un scénario sur MachineManager.
+ * \return les statistiques et l'inventaire final
+ */
+ScriptedMachine::Stats runMachineScript(const Script &script, const ScriptedMachine::Options &options);
+
+/**
+ * Exécute un scénario sur MachineManager et affiche le débit de
+ * transactions ainsi que les latences p50 / p99.
+ * \return EXIT_SUCCESS
+ */
+int runMachineBenchmark(const Script &script, const ScriptedMachine::Options &options);
+
+#endif // SCRIPTEDMACHINE_H
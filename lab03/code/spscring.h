@@ -0,0 +1,186 @@
+/**
+  \file spscring.h
+  \author Valentin Kaelin & Lazar Pavicevic
+  \date 19.10.2026
+  \brief Tampon circulaire sans verrou pour un producteur et un consommateur.
+  Ce fichier contient SpscRing, le tampon sans verrou, et BlockingSpscRing
+  qui l'enveloppe afin de pouvoir bloquer lorsque le tampon est vide ou
+  plein. Le mutex n'est utilisé que lorsqu'un thread doit réellement attendre.
+*/
+
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+#include <pcosynchro/pcomutex.h>
+#include <pcosynchro/pcoconditionvariable.h>
+
+/** Taille d'une ligne de cache, sépare les données du producteur et du consommateur */
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * Tampon circulaire sans verrou, utilisable par exactement un producteur et
+ * un consommateur. La capacité doit être une puissance de deux afin de
+ * remplacer le modulo par un masque.
+ * Les index head et tail croissent sans fin, leur différence donne le nombre
+ * d'éléments présents. Chaque côté garde une copie locale de l'index de
+ * l'autre et ne relit l'atomique partagé que lorsque cette copie ne suffit plus.
+ */
+template<typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "La capacité doit être une puissance de deux");
+
+    static constexpr size_t MASK = Capacity - 1;
+
+    // Écrits par le producteur
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail{0};
+    size_t cachedHead{0};
+
+    // Écrits par le consommateur
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head{0};
+    size_t cachedTail{0};
+
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> elements{};
+
+public:
+
+    /**
+     * Ajoute un élément, appelé uniquement par le producteur.
+     * \return false si le tampon est plein
+     */
+    bool tryPush(const T& item) {
+        const size_t currentTail = tail.load(std::memory_order_relaxed);
+        if (currentTail - cachedHead == Capacity) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (currentTail - cachedHead == Capacity) {
+                return false;
+            }
+        }
+        elements[currentTail & MASK] = item;
+        tail.store(currentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Retire l'élément le plus ancien, appelé uniquement par le consommateur.
+     * \return false si le tampon est vide
+     */
+    bool tryPop(T& item) {
+        const size_t currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (currentHead == cachedTail) {
+                return false;
+            }
+        }
+        item = elements[currentHead & MASK];
+        head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Nombre d'éléments présents, approximatif si l'autre côté est actif */
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity() {
+        return Capacity;
+    }
+};
+
+/**
+ * Version bloquante de SpscRing. Tant que le tampon n'est ni vide ni plein,
+ * put et get ne prennent aucun verrou. Un thread qui doit attendre l'annonce
+ * via un drapeau atomique avant de se bloquer sur une variable de condition,
+ * et l'autre côté ne prend le mutex pour le réveiller que si ce drapeau est levé.
+ * Les conditions sont réévaluées en boucle, un réveil intempestif est sans effet.
+ */
+template<typename T, size_t Capacity>
+class BlockingSpscRing {
+    SpscRing<T, Capacity> ring;
+
+    PcoMutex mutex;
+    PcoConditionVariable waitProd, waitConso;
+    std::atomic<bool> prodWaiting{false}, consoWaiting{false};
+
+    /** Réveille le thread en attente de l'autre côté, s'il y en a un */
+    void wakeUp(std::atomic<bool>& waiting, PcoConditionVariable& cond) {
+        // Ordonne la publication de l'élément avant la lecture du drapeau,
+        // en symétrie avec la barrière de park()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed)) {
+            mutex.lock();
+            cond.notifyOne();
+            mutex.unlock();
+        }
+    }
+
+    /** Annonce l'attente, doit être appelé avec le mutex pris */
+    void park(std::atomic<bool>& waiting) {
+        waiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+public:
+
+    /** Ajoute un élément, bloque tant que le tampon est plein */
+    void put(const T& item) {
+        if (!ring.tryPush(item)) {
+            mutex.lock();
+            park(prodWaiting);
+            while (!ring.tryPush(item)) {
+                waitProd.wait(&mutex);
+            }
+            prodWaiting.store(false, std::memory_order_relaxed);
+            mutex.unlock();
+        }
+        wakeUp(consoWaiting, waitConso);
+    }
+
+    /**
+     * Ajoute un élément en attendant au plus le délai donné si le tampon
+     * est plein.
+     * \return true si l'élément a été ajouté, false si le délai a expiré
+     */
+    bool putForSeconds(const T& item, int seconds) {
+        if (!ring.tryPush(item)) {
+            bool pushed;
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+            mutex.lock();
+            park(prodWaiting);
+            while (!(pushed = ring.tryPush(item)) && std::chrono::steady_clock::now() < deadline) {
+                waitProd.waitForSeconds(&mutex, 1);
+            }
+            prodWaiting.store(false, std::memory_order_relaxed);
+            mutex.unlock();
+            if (!pushed) {
+                return false;
+            }
+        }
+        wakeUp(consoWaiting, waitConso);
+        return true;
+    }
+
+    /** Retire l'élément le plus ancien, bloque tant que le tampon est vide */
+    T get() {
+        T item;
+        if (!ring.tryPop(item)) {
+            mutex.lock();
+            park(consoWaiting);
+            while (!ring.tryPop(item)) {
+                waitConso.wait(&mutex);
+            }
+            consoWaiting.store(false, std::memory_order_relaxed);
+            mutex.unlock();
+        }
+        wakeUp(prodWaiting, waitProd);
+        return item;
+    }
+};
+
+#endif // SPSCRING_H
@@ -0,0 +1,61 @@
+/*
+Auteurs: Valentin Kaelin & Lazar Pavicevic
+Date: 19.10.2026
+Description: Rejeu déterministe des scénarios en mode lockstep
+*/
+
+#include <gtest/gtest.h>
+#include <pcosynchro/pcotest.h>
+
+#include "asynclogger.h"
+#include "scriptedmachine.h"
+
+namespace {
+
+ScriptedMachine::Options lockstepOptions(int keyTimeoutMs)
+{
+    ScriptedMachine::Options options;
+    options.respectTimestamps = false;
+    options.lockstep = true;
+    options.keyTimeoutMs = keyTimeoutMs;
+    return options;
+}
+
+void expectSameReplay(const Script &script, const ScriptedMachine::Options &options)
+{
+    ScriptedMachine::Stats first = runMachineScript(script, options);
+    ScriptedMachine::Stats second = runMachineScript(script, options);
+
+    EXPECT_EQ(first.nbEvents, second.nbEvents);
+    EXPECT_EQ(first.nbArticlesSold, second.nbArticlesSold);
+    EXPECT_EQ(first.coins, second.coins);
+    EXPECT_EQ(first.articles, second.articles);
+}
+
+} // namespace
+
+// Dates nulles: une demande de confirmation n'expire qu'au choix d'un
+// nouvel article
+TEST(Replay, SameTraceTwice)
+{
+    AsyncLogger::instance().setLevel(LOG_LEVEL_ERROR);
+    ASSERT_DURATION_LE(30, ({
+        expectSameReplay(ScriptedMachine::generate(42, 20000, 0), lockstepOptions(100));
+    }))
+}
+
+// Les demandes expirent aussi sur les dates de la trace, quel que soit le
+// temps réel pris par le rejeu
+TEST(Replay, KeyTimeoutOnScriptTime)
+{
+    AsyncLogger::instance().setLevel(LOG_LEVEL_ERROR);
+    ASSERT_DURATION_LE(30, ({
+        expectSameReplay(ScriptedMachine::generate(7, 20000, 1000), lockstepOptions(2));
+    }))
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
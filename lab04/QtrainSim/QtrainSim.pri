@@ -88,6 +88,11 @@ SOURCES += \
     $$PWD/src/voiebuttoir.cpp \
     $$PWD/src/voietraverseejonction.cpp \
     $$PWD/src/simview.cpp \
+    $$PWD/src/simcore.cpp \
+    $$PWD/src/batchrunner.cpp \
+    $$PWD/src/cachemaquette.cpp \
+    $$PWD/src/generateurmaquette.cpp \
+    $$PWD/src/buscontacts.cpp \
     $$PWD/src/commandetrain.cpp \
     $$PWD/src/loco.cpp \
     $$PWD/src/contact.cpp \
@@ -109,6 +114,11 @@ HEADERS += \
     $$PWD/src/voiebuttoir.h \
     $$PWD/src/voietraverseejonction.h \
     $$PWD/src/simview.h \
+    $$PWD/src/simcore.h \
+    $$PWD/src/batchrunner.h \
+    $$PWD/src/cachemaquette.h \
+    $$PWD/src/generateurmaquette.h \
+    $$PWD/src/buscontacts.h \
     $$PWD/src/connect.h \
     $$PWD/src/commandetrain.h \
     $$PWD/src/general.h \
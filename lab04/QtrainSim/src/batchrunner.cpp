@@ -0,0 +1,308 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <QApplication>
+#include <QEventLoop>
+#include <QProcess>
+#include <QThread>
+
+#include "batchrunner.h"
+#include "commandetrain.h"
+#include "simview.h"
+
+static BatchRunner* instance = nullptr;
+
+BatchRunner::BatchRunner(const OptionsBatch &options)
+{
+    this->options = options;
+    this->simView = nullptr;
+    this->simCore = nullptr;
+    this->reste = 0.0;
+    this->tempsImmobile = 0.0;
+    this->aRoule = false;
+    this->contactFranchi = false;
+    CONNECT(&timer, SIGNAL(timeout()), this, SLOT(avancer()));
+}
+
+BatchRunner* BatchRunner::getInstance()
+{
+    return instance;
+}
+
+bool BatchRunner::estDemande(int argc, char *argv[])
+{
+    for(int i = 1; i < argc; i++)
+        if(strcmp(argv[i], "--batch") == 0)
+            return true;
+    return false;
+}
+
+bool BatchRunner::estActif()
+{
+    return instance != nullptr;
+}
+
+QString BatchRunner::maquetteImposee()
+{
+    if(instance == nullptr)
+        return QString();
+    return instance->options.maquettes.value(0);
+}
+
+bool BatchRunner::analyserArguments(const QStringList &arguments, OptionsBatch &options)
+{
+    bool ok = true;
+
+    options.nbProcessus = QThread::idealThreadCount();
+
+    for(int i = 1; i < arguments.size() && ok; i++)
+    {
+        const QString &argument = arguments.at(i);
+        bool aUneValeur = i + 1 < arguments.size();
+
+        if(argument == "--batch")
+            continue;
+        else if(argument == "--tours" && aUneValeur)
+            options.nbTours = arguments.at(++i).toInt(&ok);
+        else if(argument == "--acceleration" && aUneValeur)
+            options.acceleration = arguments.at(++i).toDouble(&ok);
+        else if(argument == "--interblocage" && aUneValeur)
+            options.delaiInterblocage = arguments.at(++i).toDouble(&ok);
+        else if(argument == "--duree-max" && aUneValeur)
+            options.dureeMax = arguments.at(++i).toDouble(&ok);
+        else if(argument == "--jobs" && aUneValeur)
+            options.nbProcessus = arguments.at(++i).toInt(&ok);
+        else if(argument.startsWith("-"))
+            ok = false;
+        else
+            options.maquettes.append(argument);
+    }
+
+    return ok && options.nbTours > 0 && options.acceleration > 0.0 && options.nbProcessus > 0;
+}
+
+int BatchRunner::executer(const QStringList &arguments)
+{
+    OptionsBatch options;
+
+    if(!analyserArguments(arguments, options))
+    {
+        fprintf(stderr, "Usage: %s --batch [--tours N] [--acceleration X] [--interblocage S]\n"
+                        "          [--duree-max S] [--jobs N] [maquette...]\n",
+                qPrintable(arguments.value(0)));
+        return ERREUR;
+    }
+
+    if(options.maquettes.size() > 1)
+        return lancerScenarios(options);
+
+    // Un seul scénario : il s'exécute dans ce processus
+    instance = new BatchRunner(options);
+    CommandeTrain::getInstance()->init_maquette();
+    return qApp->exec();
+}
+
+int BatchRunner::lancerScenarios(const OptionsBatch &options)
+{
+    QStringList argumentsCommuns;
+    argumentsCommuns << "--batch"
+                     << "--tours" << QString::number(options.nbTours)
+                     << "--acceleration" << QString::number(options.acceleration)
+                     << "--interblocage" << QString::number(options.delaiInterblocage)
+                     << "--duree-max" << QString::number(options.dureeMax);
+
+    QEventLoop boucle;
+    int prochain = 0;
+    int enCours = 0;
+    int nbReussis = 0;
+    int pire = SUCCES;
+
+    std::function<void()> lancerSuivant = [&]()
+    {
+        while(enCours < options.nbProcessus && prochain < options.maquettes.size())
+        {
+            QString maquette = options.maquettes.at(prochain++);
+            QProcess* processus = new QProcess();
+            // Seul le rapport, écrit sur la sortie standard, est conservé
+            processus->setStandardErrorFile(QProcess::nullDevice());
+
+            QObject::connect(processus, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+                             [&, processus, maquette](int code, QProcess::ExitStatus statut)
+            {
+                if(statut != QProcess::NormalExit)
+                    code = ERREUR;
+                printf("=== %s (code %d)\n%s\n", qPrintable(maquette), code,
+                       processus->readAllStandardOutput().constData());
+                fflush(stdout);
+
+                if(code == SUCCES)
+                    nbReussis++;
+                pire = qMax(pire, code);
+                processus->deleteLater();
+                enCours--;
+
+                lancerSuivant();
+                if(enCours == 0)
+                    boucle.quit();
+            });
+
+            processus->start(QCoreApplication::applicationFilePath(), QStringList(argumentsCommuns) << maquette);
+            enCours++;
+        }
+    };
+
+    lancerSuivant();
+    boucle.exec();
+
+    printf("Scénarios: %d, réussis: %d\n", options.maquettes.size(), nbReussis);
+    return pire;
+}
+
+void BatchRunner::demarrer(SimView *simView)
+{
+    this->simView = simView;
+    this->simCore = simView->getSimCore();
+
+    simCore->setObservateurContact([this](int numLoco, int numContact)
+    {
+        contactActive(numLoco, numContact);
+    });
+
+    chrono.start();
+    timer.start(1);
+}
+
+void BatchRunner::contactActive(int numLoco, int numContact)
+{
+    StatistiquesLoco &s = statistiques[numLoco];
+
+    if(s.contactReference < 0)
+        s.contactReference = numContact;
+    else if(s.contactReference == numContact)
+        s.nbTours++;
+
+    Contact* c = simView->getContact(numContact);
+    if(c != nullptr)
+        c->active(numLoco);
+    contactFranchi = true;
+}
+
+void BatchRunner::avancer()
+{
+    reste += chrono.restart() / 1000.0 * options.acceleration;
+
+    while(reste >= SimCore::PAS_TEMPS)
+    {
+        simCore->pas();
+        reste -= SimCore::PAS_TEMPS;
+        if(verifier())
+            return;
+
+        // Les threads réveillés par le contact envoient leurs commandes par
+        // des signaux en file : la boucle d'événements doit les appliquer
+        // avant le pas suivant. Le temps restant est simulé au prochain appel.
+        if(contactFranchi)
+        {
+            contactFranchi = false;
+            return;
+        }
+    }
+}
+
+bool BatchRunner::verifier()
+{
+    const QMap<int, LocoSim> &locos = simCore->getLocos();
+
+    QList<QPair<int, int>> collisions = simCore->collisions();
+    if(!collisions.isEmpty())
+    {
+        terminer(COLLISION, QString("collision entre les locos %1 et %2")
+                 .arg(collisions.first().first).arg(collisions.first().second));
+        return true;
+    }
+
+    bool toutesArretees = !locos.isEmpty();
+    bool toursEffectues = !locos.isEmpty();
+
+    for(const LocoSim &l : locos)
+    {
+        if(l.deraille)
+        {
+            terminer(COLLISION, QString("déraillement de la loco %1").arg(l.numLoco));
+            return true;
+        }
+
+        StatistiquesLoco &s = statistiques[l.numLoco];
+
+        if(l.vitesse == 0)
+        {
+            if(s.attenteCourante == 0.0)
+                s.nbArrets++;
+            s.attenteCourante += SimCore::PAS_TEMPS;
+            s.tempsArret += SimCore::PAS_TEMPS;
+            s.attenteMax = qMax(s.attenteMax, s.attenteCourante);
+        }
+        else
+        {
+            s.attenteCourante = 0.0;
+            aRoule = true;
+        }
+
+        if(l.vitesse != 0 || l.vitesseFuture != 0 || l.inverser)
+            toutesArretees = false;
+        if(s.nbTours < options.nbTours)
+            toursEffectues = false;
+    }
+
+    if(toursEffectues)
+    {
+        terminer(SUCCES, QString("%1 tours effectués par chaque loco").arg(options.nbTours));
+        return true;
+    }
+
+    // Les locos n'ont pas encore démarré tant qu'aucune n'a roulé
+    tempsImmobile = toutesArretees && aRoule ? tempsImmobile + SimCore::PAS_TEMPS : 0.0;
+    if(tempsImmobile >= options.delaiInterblocage)
+    {
+        terminer(INTERBLOCAGE, QString("toutes les locos sont arrêtées depuis %1 s").arg(tempsImmobile, 0, 'f', 1));
+        return true;
+    }
+
+    if(simCore->getNbPas() * SimCore::PAS_TEMPS >= options.dureeMax)
+    {
+        terminer(DUREE_DEPASSEE, QString("durée maximale de %1 s atteinte").arg(options.dureeMax));
+        return true;
+    }
+
+    return false;
+}
+
+void BatchRunner::terminer(Resultat resultat, const QString &detail)
+{
+    static const char* noms[] = {"succès", "collision", "interblocage", "durée dépassée", "erreur"};
+
+    timer.stop();
+
+    qreal temps = simCore->getNbPas() * SimCore::PAS_TEMPS;
+    qreal heures = temps / 3600.0;
+
+    // std::cout est redirigé vers la console de la fenêtre principale
+    printf("Maquette: %s\n", qPrintable(options.maquettes.value(0, "choisie par le programme")));
+    printf("Résultat: %s (%s)\n", noms[resultat], qPrintable(detail));
+    printf("Temps simulé: %.1f s\n", temps);
+    for(auto it = statistiques.cbegin(); it != statistiques.cend(); ++it)
+    {
+        const StatistiquesLoco &s = it.value();
+        printf("Loco %d: %d tours, %.1f tours/heure, %d arrêts, attente totale %.1f s, "
+               "attente moyenne %.1f s, attente max %.1f s\n",
+               it.key(), s.nbTours, heures > 0.0 ? s.nbTours / heures : 0.0, s.nbArrets,
+               s.tempsArret, s.nbArrets > 0 ? s.tempsArret / s.nbArrets : 0.0, s.attenteMax);
+    }
+    fflush(stdout);
+
+    // Les threads du programme de contrôle sont bloqués sur leurs contacts et
+    // ne se terminent jamais : le processus s'arrête sans détruire les objets
+    // statiques qu'ils utilisent encore.
+    std::_Exit(resultat);
+}
@@ -0,0 +1,137 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <QElapsedTimer>
+#include <QMap>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+
+#include "simcore.h"
+
+class SimView;
+
+/** Options d'une exécution sans affichage, lues sur la ligne de commande. */
+struct OptionsBatch
+{
+    /** maquettes à simuler, une par scénario. Vide : celle choisie par le programme. */
+    QStringList maquettes;
+    /** nombre de tours que chaque loco doit effectuer. */
+    int nbTours = 10;
+    /** rapport entre le temps simulé et le temps réel. */
+    qreal acceleration = 10.0;
+    /** durée simulée, en secondes, pendant laquelle toutes les locos peuvent
+      * rester arrêtées avant que l'on conclue à un interblocage. */
+    qreal delaiInterblocage = 60.0;
+    /** durée simulée maximale d'un scénario, en secondes. */
+    qreal dureeMax = 24.0 * 3600.0;
+    /** nombre de scénarios exécutés en parallèle. */
+    int nbProcessus = 1;
+};
+
+/** Exécute le programme de contrôle des trains sans affichage, en temps
+  * accéléré, et juge le résultat.
+  *
+  * La maquette est chargée comme dans l'application graphique, mais la
+  * fenêtre n'est jamais affichée. Le coeur de simulation de la vue est
+  * avancé directement ; chaque passage sur un contact réveille les threads
+  * qui l'attendent, puis la simulation rend la main à la boucle d'événements
+  * pour que leurs commandes soient appliquées avant le pas suivant. L'exécution s'arrête dès que chaque loco a effectué le
+  * nombre de tours voulu, ou en cas de collision, d'interblocage ou de
+  * dépassement de la durée maximale.
+  *
+  * Un tour est compté chaque fois qu'une loco repasse sur le premier
+  * contact qu'elle a franchi.
+  */
+class BatchRunner : public QObject
+{
+    Q_OBJECT
+public:
+    /** Codes de sortie du processus. */
+    enum Resultat
+    {
+        SUCCES = 0,
+        COLLISION = 1,
+        INTERBLOCAGE = 2,
+        DUREE_DEPASSEE = 3,
+        ERREUR = 4
+    };
+
+    /** Retourne vrai si la ligne de commande demande une exécution sans affichage.
+      * A appeler avant la création de QApplication.
+      */
+    static bool estDemande(int argc, char *argv[]);
+
+    /** Retourne vrai si l'application s'exécute sans affichage. */
+    static bool estActif();
+
+    /** Point d'entrée de l'exécution sans affichage.
+      * Plusieurs maquettes sont simulées par autant de processus fils.
+      * \param arguments les arguments de la ligne de commande.
+      * \return le code de sortie du processus.
+      */
+    static int executer(const QStringList &arguments);
+
+    /** Retourne la maquette imposée par la ligne de commande, vide si aucune. */
+    static QString maquetteImposee();
+
+    /** Commence à faire avancer la simulation de la vue.
+      * \param simView la vue contenant la maquette.
+      */
+    void demarrer(SimView* simView);
+
+    /** Retourne l'unique instance, nullptr sans exécution sans affichage. */
+    static BatchRunner* getInstance();
+
+private slots:
+    /** Avance la simulation du temps réel écoulé multiplié par l'accélération,
+      * en s'interrompant après le pas où une loco a franchi un contact. */
+    void avancer();
+
+private:
+    explicit BatchRunner(const OptionsBatch &options);
+
+    /** Statistiques d'une loco. */
+    struct StatistiquesLoco
+    {
+        int contactReference = -1;
+        int nbTours = 0;
+        int nbArrets = 0;
+        qreal tempsArret = 0.0;
+        qreal attenteMax = 0.0;
+        qreal attenteCourante = 0.0;
+    };
+
+    /** lit les options de la ligne de commande.
+      * \return faux si elles sont invalides.
+      */
+    static bool analyserArguments(const QStringList &arguments, OptionsBatch &options);
+
+    /** exécute chaque maquette dans un processus fils. */
+    static int lancerScenarios(const OptionsBatch &options);
+
+    /** reçoit le passage d'une loco sur un contact. */
+    void contactActive(int numLoco, int numContact);
+
+    /** met à jour les statistiques et vérifie les conditions de fin après un pas.
+      * \return vrai si la simulation est terminée.
+      */
+    bool verifier();
+
+    /** affiche le rapport et termine le processus. */
+    void terminer(Resultat resultat, const QString &detail);
+
+    OptionsBatch options;
+    SimView* simView;
+    SimCore* simCore;
+    QTimer timer;
+    QElapsedTimer chrono;
+    qreal reste;
+    qreal tempsImmobile;
+    bool aRoule;
+    /** une loco a franchi un contact pendant le dernier pas. */
+    bool contactFranchi;
+    QMap<int, StatistiquesLoco> statistiques;
+};
+
+#endif // BATCHRUNNER_H
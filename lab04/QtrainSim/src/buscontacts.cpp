@@ -0,0 +1,99 @@
+#include "buscontacts.h"
+
+BusContacts::BusContacts()
+{
+    this->sequence = 0;
+}
+
+BusContacts* BusContacts::getInstance()
+{
+    static BusContacts instance;
+    return &instance;
+}
+
+quint64 BusContacts::cle(int numContact, int numLoco)
+{
+    return (quint64(quint32(numContact)) << 32) | quint32(numLoco);
+}
+
+bool BusContacts::convient(const Attente &attente, const EvenementContact &evenement)
+{
+    return attente.numLoco == TOUTES_LOCOS || attente.numLoco == evenement.numLoco;
+}
+
+quint64 BusContacts::publier(int numContact, int numLoco)
+{
+    QMutexLocker verrou(&mutex);
+
+    EvenementContact evenement;
+    evenement.sequence = ++sequence;
+    evenement.numContact = numContact;
+    evenement.numLoco = numLoco;
+
+    derniersParContact.insert(numContact, evenement);
+    derniersParLoco.insert(cle(numContact, numLoco), evenement);
+
+    // Seules les attentes inscrites sur ce contact sont parcourues
+    auto it = attentes.find(numContact);
+    if(it != attentes.end())
+    {
+        for(Attente* attente : it.value())
+        {
+            if(!attente->servie && convient(*attente, evenement))
+            {
+                attente->servie = true;
+                attente->evenement = evenement;
+                attente->condition.wakeOne();
+            }
+        }
+    }
+
+    return evenement.sequence;
+}
+
+quint64 BusContacts::getSequence()
+{
+    QMutexLocker verrou(&mutex);
+    return sequence;
+}
+
+EvenementContact BusContacts::attendre(int numContact, int numLoco, quint64 depuis)
+{
+    return attendreUnParmi(QVector<int>() << numContact, numLoco, depuis);
+}
+
+EvenementContact BusContacts::attendreUnParmi(const QVector<int> &contacts, int numLoco, quint64 depuis)
+{
+    QMutexLocker verrou(&mutex);
+
+    // Un passage a peut-être déjà eu lieu depuis la séquence donnée
+    EvenementContact dejaPasse;
+    for(int numContact : contacts)
+    {
+        EvenementContact e = numLoco == TOUTES_LOCOS ? derniersParContact.value(numContact)
+                                                     : derniersParLoco.value(cle(numContact, numLoco));
+        if(e.sequence > depuis && e.sequence > dejaPasse.sequence)
+            dejaPasse = e;
+    }
+    if(dejaPasse.sequence > 0)
+        return dejaPasse;
+
+    Attente attente;
+    attente.numLoco = numLoco;
+
+    for(int numContact : contacts)
+        attentes[numContact].append(&attente);
+
+    while(!attente.servie)
+        attente.condition.wait(&mutex);
+
+    for(int numContact : contacts)
+    {
+        QList<Attente*> &liste = attentes[numContact];
+        liste.removeOne(&attente);
+        if(liste.isEmpty())
+            attentes.remove(numContact);
+    }
+
+    return attente.evenement;
+}
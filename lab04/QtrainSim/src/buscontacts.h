@@ -0,0 +1,96 @@
+#ifndef BUSCONTACTS_H
+#define BUSCONTACTS_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+
+/** Passage d'une loco sur un contact. */
+struct EvenementContact
+{
+    /** numéro de séquence, strictement croissant d'un passage au suivant. */
+    quint64 sequence = 0;
+    int numContact = -1;
+    int numLoco = -1;
+};
+
+/** Bus des passages sur les contacts.
+  *
+  * Chaque passage publié reçoit un numéro de séquence. Un thread attend un
+  * passage postérieur à une séquence donnée, sur un ou plusieurs contacts,
+  * éventuellement d'une loco précise. Si un tel passage a déjà eu lieu, il
+  * est retourné sans attendre : un passage survenu entre la lecture de la
+  * séquence et le début de l'attente n'est jamais perdu.
+  *
+  * Chaque attente a sa propre condition et n'est inscrite que sur les
+  * contacts qu'elle surveille : un passage ne réveille que les threads qu'il
+  * concerne.
+  */
+class BusContacts
+{
+public:
+    /** Valeur de numLoco acceptant le passage de n'importe quelle loco. */
+    static const int TOUTES_LOCOS = -1;
+
+    /** Retourne l'unique instance du bus. */
+    static BusContacts* getInstance();
+
+    /** Publie le passage d'une loco sur un contact et réveille les attentes concernées.
+      * Ne bloque pas : peut être appelé depuis le thread de l'interface.
+      * \param numContact le numéro du contact.
+      * \param numLoco le numéro de la loco.
+      * \return le numéro de séquence du passage.
+      */
+    quint64 publier(int numContact, int numLoco);
+
+    /** Retourne le numéro de séquence du dernier passage publié, 0 si aucun. */
+    quint64 getSequence();
+
+    /** Attend un passage sur un contact.
+      * \param numContact le numéro du contact.
+      * \param numLoco la loco attendue, TOUTES_LOCOS pour n'importe laquelle.
+      * \param depuis seuls les passages de séquence supérieure sont pris en compte.
+      * \return le passage.
+      */
+    EvenementContact attendre(int numContact, int numLoco, quint64 depuis);
+
+    /** Attend un passage sur l'un des contacts donnés.
+      * Si plusieurs passages antérieurs à l'appel conviennent, le plus récent est retourné.
+      * \param contacts les numéros des contacts surveillés.
+      * \param numLoco la loco attendue, TOUTES_LOCOS pour n'importe laquelle.
+      * \param depuis seuls les passages de séquence supérieure sont pris en compte.
+      * \return le passage.
+      */
+    EvenementContact attendreUnParmi(const QVector<int> &contacts, int numLoco, quint64 depuis);
+
+private:
+    BusContacts();
+
+    /** Thread en attente, inscrit sur chacun des contacts qu'il surveille. */
+    struct Attente
+    {
+        int numLoco;
+        bool servie = false;
+        EvenementContact evenement;
+        QWaitCondition condition;
+    };
+
+    /** retourne la clé d'une paire (contact, loco) dans derniersParLoco. */
+    static quint64 cle(int numContact, int numLoco);
+
+    /** retourne vrai si le passage satisfait l'attente. */
+    static bool convient(const Attente &attente, const EvenementContact &evenement);
+
+    QMutex mutex;
+    quint64 sequence;
+    /** dernier passage sur chaque contact, toutes locos confondues. */
+    QHash<int, EvenementContact> derniersParContact;
+    /** dernier passage de chaque loco sur chaque contact, voir cle. */
+    QHash<quint64, EvenementContact> derniersParLoco;
+    /** attentes inscrites sur chaque contact. */
+    QHash<int, QList<Attente*>> attentes;
+};
+
+#endif // BUSCONTACTS_H
@@ -0,0 +1,151 @@
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include "cachemaquette.h"
+
+/** "QTMC" : QtrainSim Maquette Compilée. */
+static const quint32 MAGIE_CACHE = 0x51544d43;
+/** à incrémenter à chaque changement du format ou du calcul de la géométrie. */
+static const quint32 VERSION_CACHE = 1;
+
+/** écrit la taille et la date de modification des fichiers sources. */
+static void ecrireSignature(QDataStream &flux, const QString &fichierMaquette, const QString &fichierInfosVoies)
+{
+    QFileInfo maquette(fichierMaquette);
+    QFileInfo infos(fichierInfosVoies);
+
+    flux << MAGIE_CACHE << VERSION_CACHE
+         << qint64(maquette.size()) << qint64(maquette.lastModified().toMSecsSinceEpoch())
+         << qint64(infos.size()) << qint64(infos.lastModified().toMSecsSinceEpoch());
+}
+
+static void preparerFlux(QDataStream &flux)
+{
+    flux.setVersion(QDataStream::Qt_5_0);
+    flux.setByteOrder(QDataStream::LittleEndian);
+    flux.setFloatingPointPrecision(QDataStream::DoublePrecision);
+}
+
+QString CacheMaquette::cheminCache(const QString &fichierMaquette)
+{
+    QString repertoire = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if(repertoire.isEmpty())
+        repertoire = QDir::tempPath();
+
+    // Deux maquettes de même nom dans des répertoires différents ne partagent pas leur cache
+    QFileInfo info(fichierMaquette);
+    return QString("%1/%2-%3.cache").arg(repertoire)
+                                     .arg(info.completeBaseName())
+                                     .arg(qHash(info.absoluteFilePath()), 8, 16, QChar('0'));
+}
+
+bool CacheMaquette::charger(const QString &fichierMaquette, const QString &fichierInfosVoies, DescriptionMaquette &maquette)
+{
+    QFile fichier(cheminCache(fichierMaquette));
+
+    if(!fichier.open(QIODevice::ReadOnly) || fichier.size() == 0)
+        return false;
+
+    uchar* projection = fichier.map(0, fichier.size());
+    if(projection == nullptr)
+        return false;
+
+    // Le flux lit directement la projection, sans copie du fichier
+    QByteArray donnees = QByteArray::fromRawData(reinterpret_cast<const char*>(projection), int(fichier.size()));
+    QDataStream flux(donnees);
+    preparerFlux(flux);
+
+    QByteArray attendue;
+    {
+        QDataStream signature(&attendue, QIODevice::WriteOnly);
+        preparerFlux(signature);
+        ecrireSignature(signature, fichierMaquette, fichierInfosVoies);
+    }
+
+    bool valide = donnees.startsWith(attendue);
+
+    if(valide)
+    {
+        flux.skipRawData(attendue.size());
+
+        qint32 nb;
+
+        flux >> nb;
+        maquette.voies.resize(qMax(nb, 0));
+        for(DescriptionVoie &v : maquette.voies)
+            flux >> v.id >> v.type >> v.direction >> v.liaisons >> v.geometrie;
+
+        flux >> nb;
+        maquette.contacts.resize(qMax(nb, 0));
+        for(QPair<qint32, qint32> &c : maquette.contacts)
+            flux >> c.first >> c.second;
+
+        flux >> nb;
+        maquette.voiesVariables.resize(qMax(nb, 0));
+        for(QPair<qint32, qint32> &v : maquette.voiesVariables)
+            flux >> v.first >> v.second;
+
+        flux >> maquette.premiereVoie;
+
+        flux >> nb;
+        maquette.segments.resize(qMax(nb, 0));
+        for(DescriptionSegment &s : maquette.segments)
+            flux >> s.contact1 >> s.contact2 >> s.voies;
+
+        valide = flux.status() == QDataStream::Ok && flux.atEnd();
+    }
+
+    fichier.unmap(projection);
+
+    if(!valide)
+        maquette = DescriptionMaquette();
+
+    return valide;
+}
+
+bool CacheMaquette::sauver(const QString &fichierMaquette, const QString &fichierInfosVoies, const DescriptionMaquette &maquette)
+{
+    QString chemin = cheminCache(fichierMaquette);
+    QDir().mkpath(QFileInfo(chemin).absolutePath());
+
+    // QSaveFile remplace le cache d'un coup : un chargement concurrent ne lit jamais un fichier partiel
+    QSaveFile fichier(chemin);
+    if(!fichier.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream flux(&fichier);
+    preparerFlux(flux);
+
+    ecrireSignature(flux, fichierMaquette, fichierInfosVoies);
+
+    flux << qint32(maquette.voies.size());
+    for(const DescriptionVoie &v : maquette.voies)
+        flux << v.id << v.type << v.direction << v.liaisons << v.geometrie;
+
+    flux << qint32(maquette.contacts.size());
+    for(const QPair<qint32, qint32> &c : maquette.contacts)
+        flux << c.first << c.second;
+
+    flux << qint32(maquette.voiesVariables.size());
+    for(const QPair<qint32, qint32> &v : maquette.voiesVariables)
+        flux << v.first << v.second;
+
+    flux << maquette.premiereVoie;
+
+    flux << qint32(maquette.segments.size());
+    for(const DescriptionSegment &s : maquette.segments)
+        flux << s.contact1 << s.contact2 << s.voies;
+
+    if(flux.status() != QDataStream::Ok)
+    {
+        fichier.cancelWriting();
+        return false;
+    }
+
+    return fichier.commit();
+}
@@ -0,0 +1,81 @@
+#ifndef CACHEMAQUETTE_H
+#define CACHEMAQUETTE_H
+
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+/** Voie d'une maquette, telle que décrite par une ligne du fichier texte. */
+struct DescriptionVoie
+{
+    qint32 id = 0;
+    /** numéro du type de voie dans infosVoies.txt. */
+    qint32 type = 0;
+    /** 1.0 à gauche, -1.0 à droite, pour les courbes et les aiguillages. */
+    qreal direction = 0.0;
+    /** identifiants des voies liées, dans l'ordre des liaisons. */
+    QVector<qint32> liaisons;
+    /** géométrie résolue (voir Voie::getGeometrie), vide tant que la voie n'est pas posée. */
+    QVector<qreal> geometrie;
+};
+
+/** Segment entre deux contacts, ou entre un contact et un buttoir. */
+struct DescriptionSegment
+{
+    qint32 contact1 = 0;
+    /** -1 si le segment se termine sur un buttoir. */
+    qint32 contact2 = -1;
+    /** identifiants des voies du segment, du premier contact au second. */
+    QVector<qint32> voies;
+};
+
+/** Contenu d'une maquette, indépendant des objets graphiques qui la représentent. */
+struct DescriptionMaquette
+{
+    QVector<DescriptionVoie> voies;
+    /** paires (numéro du contact, identifiant de la voie qui le porte). */
+    QVector<QPair<qint32, qint32>> contacts;
+    /** paires (numéro de la voie variable, identifiant de la voie). */
+    QVector<QPair<qint32, qint32>> voiesVariables;
+    qint32 premiereVoie = 0;
+    /** segments générés lors de la première construction, vides sinon. */
+    QVector<DescriptionSegment> segments;
+};
+
+/** Cache binaire des maquettes.
+  *
+  * La lecture d'un fichier texte de maquette, la pose des voies et
+  * l'exploration contact à contact ne dépendent que du fichier lui-même et de
+  * infosVoies.txt. Leur résultat est sauvé dans un fichier binaire compact,
+  * relu par projection en mémoire lors des chargements suivants. Le cache est
+  * reconstruit dès que la taille ou la date de modification de l'un des deux
+  * fichiers texte change.
+  */
+class CacheMaquette
+{
+public:
+    /** Lit le cache d'une maquette.
+      * \param fichierMaquette le fichier texte de la maquette.
+      * \param fichierInfosVoies le fichier de description des types de voies.
+      * \param maquette la maquette lue (retour).
+      * \return faux si le cache est absent, illisible ou périmé.
+      */
+    static bool charger(const QString &fichierMaquette, const QString &fichierInfosVoies, DescriptionMaquette &maquette);
+
+    /** Ecrit le cache d'une maquette. Une erreur d'écriture est ignorée : la
+      * maquette sera simplement relue depuis le fichier texte la fois suivante.
+      * \param fichierMaquette le fichier texte de la maquette.
+      * \param fichierInfosVoies le fichier de description des types de voies.
+      * \param maquette la maquette, avec sa géométrie et ses segments.
+      * \return vrai si le cache a été écrit.
+      */
+    static bool sauver(const QString &fichierMaquette, const QString &fichierInfosVoies, const DescriptionMaquette &maquette);
+
+    /** Retourne le chemin du cache d'une maquette.
+      * \param fichierMaquette le fichier texte de la maquette.
+      * \return le chemin du fichier de cache.
+      */
+    static QString cheminCache(const QString &fichierMaquette);
+};
+
+#endif // CACHEMAQUETTE_H
@@ -3,6 +3,7 @@
 #include <QApplication>
 #include <QThread>
 
+#include "batchrunner.h"
 #include "commandetrain.h"
 #include "mainwindow.h"
 
@@ -11,6 +12,19 @@
 static MainWindow *mainwindow;
 static SimView* simView;
 
+/** Signale un numéro de contact inexistant. Sans affichage, le programme de
+  * contrôle est fautif : l'exécution s'arrête en erreur. */
+static void contactInvalide(int no_contact)
+{
+    QString message = QString("Attention, le numéro de contact %1 n'est pas valide").arg(no_contact);
+    if (BatchRunner::estActif())
+    {
+        fprintf(stderr, "%s\n", qPrintable(message));
+        exit(BatchRunner::ERREUR);
+    }
+    QMessageBox::warning(nullptr,"Error",message);
+}
+
 
 
 
@@ -37,7 +51,8 @@ CommandeTrain* CommandeTrain::getInstance()
 void CommandeTrain::init_maquette(void)
 {
     mainwindow=new MainWindow();
-    mainwindow->show();
+    if (!BatchRunner::estActif())
+        mainwindow->show();
 
     simView = mainwindow->getSimView();
 
@@ -132,12 +147,58 @@ void CommandeTrain::attendre_contact(int no_contact)
     Contact *c=simView->getContact(no_contact);
     if (c == nullptr)
     {
-        QMessageBox::warning(nullptr,"Error",QString("Attention, le numéro de contact %1 n'est pas valide").arg(no_contact));
+        contactInvalide(no_contact);
     }
     else
         c->attendContact();
 }
 
+void CommandeTrain::attendre_contact_loco(int no_contact, int no_loco)
+{
+    Contact *c=simView->getContact(no_contact);
+    if (c == nullptr)
+    {
+        contactInvalide(no_contact);
+    }
+    else
+        c->attendContact(no_loco);
+}
+
+int CommandeTrain::attendre_contacts(const int *contacts, int nb, int no_loco, unsigned long long depuis)
+{
+    QVector<int> numeros;
+    QVector<Contact*> surveilles;
+
+    for(int i = 0; i < nb; i++)
+    {
+        Contact *c=simView->getContact(contacts[i]);
+        if (c == nullptr)
+        {
+            contactInvalide(contacts[i]);
+            return -1;
+        }
+        numeros.append(contacts[i]);
+        surveilles.append(c);
+    }
+
+    BusContacts* bus = BusContacts::getInstance();
+    if(depuis == 0)
+        depuis = bus->getSequence();
+
+    for(Contact* c : surveilles)
+        c->modifierAttente(1);
+    EvenementContact evenement = bus->attendreUnParmi(numeros, no_loco, depuis);
+    for(Contact* c : surveilles)
+        c->modifierAttente(-1);
+
+    return evenement.numContact;
+}
+
+unsigned long long CommandeTrain::sequence_contacts(void)
+{
+    return BusContacts::getInstance()->getSequence();
+}
+
 void CommandeTrain::arreter_loco(int no_loco)
 {
     emit setVitesseLoco(no_loco, 0);
@@ -176,11 +237,23 @@ void CommandeTrain::assigner_loco(int contact_a,int contact_b,int no_loco,int vi
 
 void CommandeTrain::selection_maquette(QString maquette)
 {
-    emit selectMaquette(maquette);
+    // Une maquette passée en ligne de commande remplace celle du programme
+    QString imposee = BatchRunner::maquetteImposee();
+    emit selectMaquette(imposee.isEmpty() ? maquette : imposee);
     mainwindow->semWaitMaquette.acquire();
     mainwindow->maquetteFinie.acquire();
 }
 
+int CommandeTrain::nombre_contacts(void)
+{
+    return simView->getNumContactMax() + 1;
+}
+
+int CommandeTrain::nombre_aiguillages(void)
+{
+    return simView->getNumVoieVariableMax() + 1;
+}
+
 void CommandeTrain::afficher_message(const char *message)
 {
     QString mess=QString("%1").arg(message);
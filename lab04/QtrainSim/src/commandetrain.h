@@ -80,6 +80,31 @@ public:
      */
     void attendre_contact(int no_contact);
 
+    /**
+     * Méthode bloquante, permettant d'attendre le passage d'une loco précise sur un contact.
+     * Les passages des autres locos ne réveillent pas le thread appelant.
+     * \param no_contact  Numéro du contact dont on attend l'activation.
+     * \param no_loco     Numéro de la loco attendue.
+     */
+    void attendre_contact_loco(int no_contact, int no_loco);
+
+    /**
+     * Méthode bloquante, permettant d'attendre l'activation de l'un des contacts donnés.
+     * Un passage postérieur à la séquence depuis, mais antérieur à l'appel, n'est pas perdu :
+     * la méthode retourne alors immédiatement.
+     * \param contacts    Numéros des contacts surveillés.
+     * \param nb          Nombre de contacts surveillés.
+     * \param no_loco     Numéro de la loco attendue, -1 pour n'importe laquelle.
+     * \param depuis      Séquence obtenue par sequence_contacts(), 0 pour le prochain passage.
+     * \return le numéro du contact activé, -1 si un contact n'est pas valide.
+     */
+    int attendre_contacts(const int *contacts, int nb, int no_loco, unsigned long long depuis);
+
+    /**
+     * Retourne le numéro de séquence du dernier passage sur un contact.
+     */
+    unsigned long long sequence_contacts(void);
+
     /**
      * Arrete une locomotive (met sa vitesse à  VITESSE_NULLE).
      * \param no_loco  Numéro de la loco à  stopper.
@@ -152,6 +177,20 @@ public:
       */
     void selection_maquette(QString maquette);
 
+    /**
+      * Retourne le plus grand numéro de contact de la maquette chargée, plus
+      * un : la taille d'un tableau indexé par numéro de contact.
+      * Remplace MAX_CONTACTS, qui ne vaut que pour la maquette réelle.
+      */
+    int nombre_contacts(void);
+
+    /**
+      * Retourne le plus grand numéro d'aiguillage de la maquette chargée, plus
+      * un : la taille d'un tableau indexé par numéro d'aiguillage.
+      * Remplace MAX_AIGUILLAGES, qui ne vaut que pour la maquette réelle.
+      */
+    int nombre_aiguillages(void);
+
     void afficher_message(const char *message);
 
     void afficher_message_loco(int numLoco,const char *message);
@@ -12,10 +12,7 @@ Contact::Contact(int numContact, int numVoiePorteuse, QObject *parent) :
 {
     this->numContact = numContact;
     this->numVoiePorteuse = numVoiePorteuse;
-    mutex = new QMutex();
-    VarCond = new QWaitCondition();
     setZValue(ZVAL_CONTACT);
-    waitingOn=false;
 }
 
 int Contact::getNumContact()
@@ -24,20 +21,29 @@ int Contact::getNumContact()
 }
 
 
-void Contact::attendContact()
+EvenementContact Contact::attendContact(int numLoco, quint64 depuis)
 {
-    mutex->lock();
-    waitingOn=true;
-    update();
-    VarCond->wait(mutex);
-    waitingOn=false;
-    update();
-    mutex->unlock();
+    BusContacts* bus = BusContacts::getInstance();
+
+    if(depuis == 0)
+        depuis = bus->getSequence();
+
+    modifierAttente(1);
+    EvenementContact evenement = bus->attendre(numContact, numLoco, depuis);
+    modifierAttente(-1);
+
+    return evenement;
 }
 
-void Contact::active()
+void Contact::active(int numLoco)
 {
-    VarCond->wakeAll();
+    BusContacts::getInstance()->publier(numContact, numLoco);
+}
+
+void Contact::modifierAttente(int delta)
+{
+    nbAttentes.fetchAndAddOrdered(delta);
+    update();
 }
 
 int Contact::getNumVoiePorteuse()
@@ -59,6 +65,8 @@ QRectF Contact::boundingRect() const
 
 void Contact::paint(QPainter *painter, const QStyleOptionGraphicsItem */*option*/, QWidget */*widget*/)
 {
+    bool waitingOn = nbAttentes.load() > 0;
+
     if (waitingOn)
     {
         painter->setPen(COULEUR_CONTACT_WAITING);
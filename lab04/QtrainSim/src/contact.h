@@ -3,13 +3,13 @@
 
 #include <QObject>
 #include <QAbstractGraphicsShapeItem>
-#include <QMutex>
-#include <QWaitCondition>
+#include <QAtomicInt>
 #include <QPainter>
 #include <QDebug>
 #include <math.h>
 
 #include "general.h"
+#include "buscontacts.h"
 
 class Contact : public QObject, public QAbstractGraphicsShapeItem
 {
@@ -23,13 +23,23 @@ public:
     explicit Contact(int numContact, int numVoiePorteuse, QObject *parent = 0);
 
     /** Méthode bloquante, permettant d'attendre sur l'activation du contact.
+      * \param numLoco la loco attendue, BusContacts::TOUTES_LOCOS pour n'importe laquelle.
+      * \param depuis seuls les passages de séquence supérieure sont pris en compte,
+      *        0 pour le prochain passage après l'appel.
+      * \return le passage qui a libéré le thread.
       */
-    void attendContact();
+    EvenementContact attendContact(int numLoco = BusContacts::TOUTES_LOCOS, quint64 depuis = 0);
 
     /** Méthode appelée quand une loco passe sur le contact.
-      * Libère les threads en attente.
+      * Publie le passage sur le bus des contacts, qui libère les threads concernés.
+      * \param numLoco le numéro de la loco.
       */
-    void active();
+    void active(int numLoco);
+
+    /** indique qu'un thread commence ou cesse d'attendre ce contact, pour l'affichage.
+      * \param delta +1 au début de l'attente, -1 à sa fin.
+      */
+    void modifierAttente(int delta);
 
     /** retourne le numéro de la voie porteuse.
       * \return le numéro de la voie porteuse.
@@ -62,10 +72,9 @@ public slots:
 private:
     int numVoiePorteuse;
     int numContact;
-    QWaitCondition* VarCond;
-    QMutex* mutex;
     qreal angle;
-    bool waitingOn;
+    /** nombre de threads en attente sur le contact. */
+    QAtomicInt nbAttentes;
 };
 
 #endif // CONTACT_H
@@ -141,6 +141,31 @@ void selection_maquette(const char *maquette)
     CMD_TRAIN->selection_maquette(maquette);
 }
 
+int nombre_contacts(void)
+{
+    return CMD_TRAIN->nombre_contacts();
+}
+
+int nombre_aiguillages(void)
+{
+    return CMD_TRAIN->nombre_aiguillages();
+}
+
+void attendre_contact_loco(int no_contact, int no_loco)
+{
+    CMD_TRAIN->attendre_contact_loco(no_contact, no_loco);
+}
+
+int attendre_contacts(const int *contacts, int nb, int no_loco, unsigned long long depuis)
+{
+    return CMD_TRAIN->attendre_contacts(contacts, nb, no_loco, depuis);
+}
+
+unsigned long long sequence_contacts(void)
+{
+    return CMD_TRAIN->sequence_contacts();
+}
+
 void afficher_message(const char *message)
 {
     CMD_TRAIN->afficher_message(message);
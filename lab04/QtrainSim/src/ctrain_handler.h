@@ -33,13 +33,16 @@ extern "C" {
 // Vitesse maximum
 #define	VITESSE_MAXIMUM 14
 
-// Numero max. d'aiguillage
+// Numero max. d'aiguillage de la maquette reelle.
+// Dans le simulateur, voir nombre_aiguillages().
 #define	MAX_AIGUILLAGES 80
 
-// Numero max. de contact
+// Numero max. de contact de la maquette reelle.
+// Dans le simulateur, voir nombre_contacts().
 #define MAX_CONTACTS 64
 
-// Numero max. de loco
+// Numero max. de loco de la maquette reelle.
+// Le simulateur accepte n'importe quel numero de loco.
 #define	MAX_LOCOS 80
 
 // Direction des aiguillages
@@ -153,6 +156,45 @@ void assigner_loco(int contact_a, int contact_b, int no_loco, int vitesse);
  */
 void selection_maquette(const char *maquette);
 
+/*
+ * Retourne le plus grand numero de contact de la maquette chargee, plus un.
+ * Les maquettes du simulateur n'ont pas de taille maximale : cette fonction
+ * remplace MAX_CONTACTS pour dimensionner les tableaux indexes par numero de
+ * contact, par exemple int t[nombre_contacts()].
+ */
+int nombre_contacts(void);
+
+/*
+ * Retourne le plus grand numero d'aiguillage de la maquette chargee, plus un.
+ * Remplace MAX_AIGUILLAGES, de la meme maniere que nombre_contacts().
+ */
+int nombre_aiguillages(void);
+
+/*
+ * Attend le passage d'une loco precise sur le contact donne.
+ * Les passages des autres locos ne reveillent pas le thread appelant.
+ *   no_contact : No du contact dont on attend l'activation.
+ *   no_loco    : No de la loco attendue.
+ */
+void attendre_contact_loco(int no_contact, int no_loco);
+
+/*
+ * Attend l'activation de l'un des contacts donnes et retourne son numero.
+ * Un passage posterieur a la sequence depuis n'est jamais perdu, meme s'il
+ * a eu lieu avant l'appel : la fonction retourne alors immediatement.
+ *   contacts : Nos des contacts surveilles.
+ *   nb       : nombre de contacts surveilles.
+ *   no_loco  : No de la loco attendue, -1 pour n'importe laquelle.
+ *   depuis   : valeur retournee par sequence_contacts(), 0 pour le prochain passage.
+ */
+int attendre_contacts(const int *contacts, int nb, int no_loco, unsigned long long depuis);
+
+/*
+ * Retourne le numero de sequence du dernier passage sur un contact.
+ * A lire avant d'agir sur une loco, puis a passer a attendre_contacts().
+ */
+unsigned long long sequence_contacts(void);
+
 /*
  * Affiche un message dans la console principale
  *   message : chaine de caractere qui sera affichee dans la console.
@@ -70,13 +70,13 @@
 //! Vitesse maximum
 #define	VITESSE_MAXIMUM 14
 
-//! Numero max. d'aiguillage
+//! Numero max. d'aiguillage de la maquette reelle (le simulateur n'a pas de limite)
 #define	MAX_AIGUILLAGES 80
 
-//! Numero max. de contact
+//! Numero max. de contact de la maquette reelle (le simulateur n'a pas de limite)
 #define MAX_CONTACTS 64
 
-//! Numero max. de loco
+//! Numero max. de loco de la maquette reelle (le simulateur n'a pas de limite)
 #define	MAX_LOCOS 80
 
 //! Direction des aiguillages
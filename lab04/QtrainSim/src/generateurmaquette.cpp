@@ -0,0 +1,294 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+#include <QFile>
+#include <QTextStream>
+
+#include "generateurmaquette.h"
+
+// Types de voies de infosVoies.txt utilisés par le générateur.
+/** droite de 90.0. */
+static const int DROITE_QUAI = 2201;
+/** droite de 156.0, complète la partie droite d'un aiguillage (168.9) pour
+  * égaler la longueur d'un aiguillage suivi d'une courbe de 22.5 degrés. */
+static const int DROITE_COMPENSATION = 2207;
+/** courbe de 22.5 degrés, même rayon que les aiguillages. */
+static const int COURBE_EVITEMENT = 2232;
+/** courbe de 30 degrés, six par demi-cercle. */
+static const int COURBE_OVALE = 2221;
+static const int AIGUILLAGE = 2261;
+static const int AIGUILLAGE_TRIPLE = 2270;
+static const int TRAVERSEE_JONCTION = 2260;
+
+static const int NB_COURBES_DEMI_CERCLE = 6;
+
+bool GenerateurMaquette::estDemande(int argc, char *argv[])
+{
+    for(int i = 1; i < argc; i++)
+        if(strcmp(argv[i], "--generer-maquette") == 0)
+            return true;
+    return false;
+}
+
+bool GenerateurMaquette::analyserArguments(const QStringList &arguments, OptionsGenerateur &options)
+{
+    bool ok = true;
+
+    for(int i = 1; i < arguments.size() && ok; i++)
+    {
+        const QString &argument = arguments.at(i);
+        bool aUneValeur = i + 1 < arguments.size();
+
+        if(argument == "--generer-maquette" && aUneValeur)
+            options.fichier = arguments.at(++i);
+        else if(argument == "--gares" && aUneValeur)
+            options.nbGares = arguments.at(++i).toInt(&ok);
+        else if(argument == "--quai" && aUneValeur)
+            options.longueurQuai = arguments.at(++i).toInt(&ok);
+        else if(argument == "--graine" && aUneValeur)
+            options.graine = arguments.at(++i).toUInt(&ok);
+        else
+            ok = false;
+    }
+
+    return ok && !options.fichier.isEmpty() && options.nbGares >= 0 && options.longueurQuai > 0;
+}
+
+int GenerateurMaquette::executer(const QStringList &arguments)
+{
+    OptionsGenerateur options;
+
+    if(!analyserArguments(arguments, options))
+    {
+        fprintf(stderr, "Usage: %s --generer-maquette fichier [--gares N] [--quai N] [--graine N]\n",
+                qPrintable(arguments.value(0)));
+        return EXIT_FAILURE;
+    }
+
+    GenerateurMaquette generateur(options);
+    if(!generateur.ecrire())
+    {
+        fprintf(stderr, "Impossible d'écrire %s\n", qPrintable(options.fichier));
+        return EXIT_FAILURE;
+    }
+
+    printf("%s: %d voies, %d contacts, %d aiguillages\n", qPrintable(options.fichier),
+           generateur.getNbVoies(), generateur.getNbContacts(), generateur.getNbAiguillages());
+    return EXIT_SUCCESS;
+}
+
+GenerateurMaquette::GenerateurMaquette(const OptionsGenerateur &options)
+{
+    this->options = options;
+}
+
+int GenerateurMaquette::getNbVoies() const
+{
+    return voies.size();
+}
+
+int GenerateurMaquette::getNbContacts() const
+{
+    return contacts.size();
+}
+
+int GenerateurMaquette::getNbAiguillages() const
+{
+    return aiguillages.size();
+}
+
+int GenerateurMaquette::prolonger(Extremite &fin, int type, int ordreEntree, int ordreSortie, const QString &direction)
+{
+    int nbLiaisons = 2;
+    if(type == AIGUILLAGE)
+        nbLiaisons = 3;
+    else if(type == AIGUILLAGE_TRIPLE || type == TRAVERSEE_JONCTION)
+        nbLiaisons = 4;
+
+    VoieGeneree voie;
+    voie.type = type;
+    voie.liaisons.fill(0, nbLiaisons);
+    voie.direction = direction;
+    voies.append(voie);
+
+    int id = voies.size();
+    lier(fin, Extremite(id, ordreEntree));
+    fin = Extremite(id, ordreSortie);
+
+    return id;
+}
+
+void GenerateurMaquette::lier(Extremite a, Extremite b)
+{
+    // La toute première voie n'a pas encore de voisine
+    if(a.first > 0)
+        voies[a.first - 1].liaisons[a.second] = b.first;
+    if(b.first > 0)
+        voies[b.first - 1].liaisons[b.second] = a.first;
+}
+
+int GenerateurMaquette::ajouterContact(int voie)
+{
+    contacts.append(voie);
+    return contacts.size();
+}
+
+int GenerateurMaquette::ajouterAiguillage(int voie)
+{
+    aiguillages.append(voie);
+    return aiguillages.size();
+}
+
+void GenerateurMaquette::poserQuai(Extremite &fin)
+{
+    for(int i = 0; i < options.longueurQuai; i++)
+    {
+        int voie = prolonger(fin, DROITE_QUAI, 0, 1);
+        if(i == options.longueurQuai / 2)
+            ajouterContact(voie);
+    }
+}
+
+void GenerateurMaquette::poserEvitement(Extremite depart, Extremite arrivee, const QString &direction)
+{
+    prolonger(depart, COURBE_EVITEMENT, 0, 1, direction);
+    poserQuai(depart);
+    prolonger(depart, COURBE_EVITEMENT, 0, 1, direction);
+    lier(depart, arrivee);
+}
+
+void GenerateurMaquette::poserGare(Extremite &fin, Gare gare)
+{
+    // Les aiguillages d'entrée ont leur pointe vers l'arrière, ceux de sortie
+    // vers l'avant. La voie principale d'une gare (aiguillage, compensation,
+    // quai, compensation, aiguillage) a la longueur de la voie d'évitement.
+    switch(gare)
+    {
+    case EVITEMENT:
+    {
+        int entree = prolonger(fin, AIGUILLAGE, 0, 1, "Gauche");
+        prolonger(fin, DROITE_COMPENSATION, 0, 1);
+        poserQuai(fin);
+        prolonger(fin, DROITE_COMPENSATION, 0, 1);
+        int sortie = prolonger(fin, AIGUILLAGE, 1, 0, "Droite");
+
+        poserEvitement(Extremite(entree, 2), Extremite(sortie, 2), "Droite");
+        ajouterAiguillage(entree);
+        ajouterAiguillage(sortie);
+        break;
+    }
+    case EVITEMENT_DOUBLE:
+    {
+        // Liaison 2 à gauche et 3 à droite de la pointe : les côtés s'échangent en sortie
+        int entree = prolonger(fin, AIGUILLAGE_TRIPLE, 0, 1);
+        prolonger(fin, DROITE_COMPENSATION, 0, 1);
+        poserQuai(fin);
+        prolonger(fin, DROITE_COMPENSATION, 0, 1);
+        int sortie = prolonger(fin, AIGUILLAGE_TRIPLE, 1, 0);
+
+        poserEvitement(Extremite(entree, 2), Extremite(sortie, 3), "Droite");
+        poserEvitement(Extremite(entree, 3), Extremite(sortie, 2), "Gauche");
+        ajouterAiguillage(entree);
+        ajouterAiguillage(sortie);
+        break;
+    }
+    case JONCTION:
+    {
+        // La traversée-jonction relie la voie d'évitement de droite, derrière elle,
+        // à celle de gauche, devant elle.
+        int entree = prolonger(fin, AIGUILLAGE, 0, 1, "Droite");
+        prolonger(fin, DROITE_COMPENSATION, 0, 1);
+        poserQuai(fin);
+        prolonger(fin, DROITE_COMPENSATION, 0, 1);
+        int jonction = prolonger(fin, TRAVERSEE_JONCTION, 0, 1);
+        prolonger(fin, DROITE_COMPENSATION, 0, 1);
+        poserQuai(fin);
+        prolonger(fin, DROITE_COMPENSATION, 0, 1);
+        int sortie = prolonger(fin, AIGUILLAGE, 1, 0, "Droite");
+
+        poserEvitement(Extremite(entree, 2), Extremite(jonction, 2), "Gauche");
+        poserEvitement(Extremite(jonction, 3), Extremite(sortie, 2), "Droite");
+        ajouterAiguillage(entree);
+        ajouterAiguillage(jonction);
+        ajouterAiguillage(sortie);
+        break;
+    }
+    }
+}
+
+void GenerateurMaquette::poserCote(Extremite &fin, const QVector<Gare> &gares)
+{
+    for(Gare gare : gares)
+    {
+        ajouterContact(prolonger(fin, DROITE_QUAI, 0, 1));
+        poserGare(fin, gare);
+    }
+    ajouterContact(prolonger(fin, DROITE_QUAI, 0, 1));
+
+    // Les voies d'évitement de gauche sont à l'extérieur de l'ovale
+    for(int i = 0; i < NB_COURBES_DEMI_CERCLE; i++)
+        prolonger(fin, COURBE_OVALE, 0, 1, "Droite");
+}
+
+void GenerateurMaquette::construire()
+{
+    voies.clear();
+    contacts.clear();
+    aiguillages.clear();
+
+    std::mt19937 generateur(options.graine);
+    std::uniform_int_distribution<int> tirage(EVITEMENT, JONCTION);
+
+    QVector<Gare> gares;
+    for(int i = 0; i < options.nbGares; i++)
+        gares.append(static_cast<Gare>(tirage(generateur)));
+
+    Extremite fin(0, 0);
+    poserCote(fin, gares);
+    poserCote(fin, gares);
+
+    // Fermeture de l'ovale sur la première voie
+    lier(fin, Extremite(1, 0));
+}
+
+bool GenerateurMaquette::ecrire()
+{
+    construire();
+
+    QFile fichier(options.fichier);
+    if(!fichier.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate))
+        return false;
+
+    QTextStream ecriture(&fichier);
+
+    ecriture << "Maquette generee (" << options.nbGares << " gares par cote, quais de "
+             << options.longueurQuai << " voies, graine " << options.graine << ")\n";
+
+    ecriture << voies.size() << "\n";
+    for(int i = 0; i < voies.size(); i++)
+    {
+        const VoieGeneree &v = voies.at(i);
+        ecriture << i + 1 << " " << v.type;
+        for(int liaison : v.liaisons)
+            ecriture << " " << liaison;
+        if(!v.direction.isEmpty())
+            ecriture << " " << v.direction;
+        ecriture << "\n";
+    }
+
+    ecriture << contacts.size() << "\n";
+    for(int i = 0; i < contacts.size(); i++)
+        ecriture << i + 1 << " " << contacts.at(i) << "\n";
+
+    ecriture << aiguillages.size() << "\n";
+    for(int i = 0; i < aiguillages.size(); i++)
+        ecriture << i + 1 << " " << aiguillages.at(i) << "\n";
+
+    // Première voie posée
+    ecriture << 1 << "\n";
+
+    ecriture.flush();
+    return fichier.error() == QFile::NoError;
+}
@@ -0,0 +1,124 @@
+#ifndef GENERATEURMAQUETTE_H
+#define GENERATEURMAQUETTE_H
+
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/** Options du générateur, lues sur la ligne de commande. */
+struct OptionsGenerateur
+{
+    /** fichier de maquette à écrire. */
+    QString fichier;
+    /** nombre de gares sur chacun des deux côtés de l'ovale. */
+    int nbGares = 100;
+    /** nombre de voies droites de chaque quai. */
+    int longueurQuai = 3;
+    /** graine du tirage du type des gares. */
+    quint32 graine = 1;
+};
+
+/** Génère des maquettes de grande taille, pour mesurer le simulateur et les
+  * programmes de contrôle sur des réseaux réalistes.
+  *
+  * La maquette est un ovale dont les deux côtés droits sont bordés de gares,
+  * séparées par une voie portant un contact. Chaque gare est tirée au hasard
+  * parmi trois modèles :
+  *  - une voie d'évitement, entre deux aiguillages ;
+  *  - deux voies d'évitement, de part et d'autre, entre deux aiguillages triples ;
+  *  - un passage de la voie d'évitement intérieure à la voie extérieure par une
+  *    traversée-jonction, entre deux aiguillages.
+  * Les voies d'évitement sont formées de voies Märklin dont les longueurs se
+  * compensent exactement, et les deux côtés portent la même suite de gares :
+  * la maquette se referme sans correction de position. Chaque quai porte un
+  * contact en son milieu.
+  */
+class GenerateurMaquette
+{
+public:
+    /** Retourne vrai si la ligne de commande demande la génération d'une maquette. */
+    static bool estDemande(int argc, char *argv[]);
+
+    /** Point d'entrée de la génération.
+      * \param arguments les arguments de la ligne de commande.
+      * \return le code de sortie du processus.
+      */
+    static int executer(const QStringList &arguments);
+
+    explicit GenerateurMaquette(const OptionsGenerateur &options);
+
+    /** Construit la maquette et l'écrit dans le fichier des options.
+      * \return faux si le fichier ne peut être écrit.
+      */
+    bool ecrire();
+
+    /** Retourne le nombre de voies de la maquette construite. */
+    int getNbVoies() const;
+
+    /** Retourne le nombre de contacts de la maquette construite. */
+    int getNbContacts() const;
+
+    /** Retourne le nombre d'aiguillages de la maquette construite. */
+    int getNbAiguillages() const;
+
+private:
+    /** Extrémité libre d'une voie : (identifiant de la voie, ordre de la liaison). */
+    typedef QPair<int, int> Extremite;
+
+    /** Voie telle qu'elle sera écrite dans le fichier. */
+    struct VoieGeneree
+    {
+        int type;
+        QVector<int> liaisons;
+        QString direction;
+    };
+
+    /** Modèles de gare. */
+    enum Gare
+    {
+        EVITEMENT,
+        EVITEMENT_DOUBLE,
+        JONCTION
+    };
+
+    static bool analyserArguments(const QStringList &arguments, OptionsGenerateur &options);
+
+    /** construit l'ovale complet. */
+    void construire();
+
+    /** ajoute une voie dont l'entrée est liée à l'extrémité fin, puis déplace fin sur sa sortie.
+      * \return l'identifiant de la voie ajoutée.
+      */
+    int prolonger(Extremite &fin, int type, int ordreEntree, int ordreSortie, const QString &direction = QString());
+
+    /** ajoute un quai de longueurQuai voies droites portant un contact en son milieu. */
+    void poserQuai(Extremite &fin);
+
+    /** ajoute une voie d'évitement (courbe, quai, courbe) entre deux extrémités.
+      * \param direction le sens des deux courbes : "Droite" pour une voie d'évitement
+      *        à gauche de la voie principale, "Gauche" pour une voie à droite.
+      */
+    void poserEvitement(Extremite depart, Extremite arrivee, const QString &direction);
+
+    /** ajoute un côté de l'ovale, suivi de son demi-cercle. */
+    void poserCote(Extremite &fin, const QVector<Gare> &gares);
+
+    void poserGare(Extremite &fin, Gare gare);
+
+    /** lie deux extrémités. */
+    void lier(Extremite a, Extremite b);
+
+    int ajouterContact(int voie);
+    int ajouterAiguillage(int voie);
+
+    OptionsGenerateur options;
+    /** voies, indexées par leur identifiant moins un. */
+    QVector<VoieGeneree> voies;
+    /** voie portant chaque contact, indexée par le numéro du contact moins un. */
+    QVector<int> contacts;
+    /** voie de chaque aiguillage, indexée par le numéro de l'aiguillage moins un. */
+    QVector<int> aiguillages;
+};
+
+#endif // GENERATEURMAQUETTE_H
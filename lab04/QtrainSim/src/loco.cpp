@@ -47,32 +47,21 @@ Loco::Loco(int numLoco, QObject *parent) :
     this->numLoco2->setPos(- LONGUEUR_LOCO * 0.3, 0.0);
     this->numLoco2->setRotation(this->numLoco2->rotation() + 180.0);
     this->vitesse = 0;
-    this->vitesseFuture = 0;
     this->active = true;
     this->direction = DIRECTION_LOCO_GAUCHE;
     this->angleCumule = 0.0;
     this->alerteProximite = false;
-    this->inverser = false;
     this->deraille = false;
-    this->timer = new QTimer(this);
+    this->voieActuelle = nullptr;
+    this->voieSuivante = nullptr;
     this->mutex = new QMutex();
     this->VarCond = new QWaitCondition();
     setZValue(ZVAL_LOCO);
-
-    CONNECT(timer, SIGNAL(timeout()), this, SLOT(adapterVitesse()));
 }
 
 void Loco::setVitesse(int v)
 {
-    if(TrainSimSettings::getInstance()->getInertie())
-    {
-        this->vitesseFuture = v;
-        this->timer->start(INERTIE_LOCO);
-    }
-    else
-    {
-        this->vitesse = this->vitesseFuture = v;
-    }
+    this->vitesse = v;
 }
 
 int Loco::getVitesse()
@@ -163,7 +152,11 @@ void Loco::paint(QPainter *painter, const QStyleOptionGraphicsItem */*option*/,
 
 void Loco::setVoie(Voie *v)
 {
+    if(this->voieActuelle != nullptr)
+        this->voieActuelle->modifierOccupation(-1);
     this->voieActuelle = v;
+    if(v != nullptr)
+        v->modifierOccupation(1);
 }
 
 Voie* Loco::getVoie()
@@ -200,36 +193,23 @@ void Loco::avanceDUneVoie()
 
     voieActuelle = voieSuivante;
 
+    viensDe->modifierOccupation(-1);
+    voieActuelle->modifierOccupation(1);
+
     voieSuivante = voieActuelle->getVoieSuivante(viensDe);
 
     setPos(voieActuelle->getPosAbsLiaison(viensDe));
 
     corrigerAngle(voieActuelle->getNouvelAngle(viensDe));
+}
 
-    if(voieActuelle->getContact() != nullptr)
+void Loco::passeContact(int numContact, Segment *s)
+{
+    setSegmentActuel(s);
+    if (TrainSimSettings::getInstance()->getViewLocoLog())
     {
-        Contact* ctc1 = voieActuelle->getContact();
-        Contact* ctc2 = nullptr;
-        viensDe = voieActuelle;
-        Voie* v1 = voieSuivante;
-        Voie* v2 = v1->getVoieSuivante(viensDe);
-
-        while (ctc2 == nullptr)
-        {
-            ctc2 = v1->getContact();
-            viensDe = v1;
-            v1 = v2;
-            v2 = v1->getVoieSuivante(viensDe);
-        }
-
-        nouveauSegment(ctc1, ctc2, this);
-
-        voieActuelle->getContact()->active(); //pas ideal... A revoir.
-        if (TrainSimSettings::getInstance()->getViewLocoLog())
-        {
-            this->controller->console->append(QString("# Passe le contact numéro %1").arg(voieActuelle->getContact()->getNumContact()));
-            std::cout << "Loco " << this->numLoco1->getNumLoco() << " : Passe le contact " << voieActuelle->getContact()->getNumContact() << std::endl;
-        }
+        this->controller->console->append(QString("# Passe le contact numéro %1").arg(numContact));
+        std::cout << "Loco " << this->numLoco1->getNumLoco() << " : Passe le contact " << numContact << std::endl;
     }
 }
 
@@ -315,18 +295,10 @@ QPolygonF Loco::getContour()
 
 void Loco::inverserSens()
 {
-    if(TrainSimSettings::getInstance()->getInertie())
-    {
-        inverser = true;
-        this->timer->start(INERTIE_LOCO);
-    }
-    else
-    {
-        this->setRotation(this->rotation() + 180.0);
-        Voie* viensDe = voieSuivante;
-        voieSuivante = voieActuelle->getVoieSuivante(viensDe);
-        this->angleCumule -= 180.0;
-    }
+    this->setRotation(this->rotation() + 180.0);
+    Voie* viensDe = voieSuivante;
+    voieSuivante = voieActuelle->getVoieSuivante(viensDe);
+    this->angleCumule -= 180.0;
 }
 
 void Loco::corrigerAngle(qreal nouvelAngle)
@@ -355,33 +327,7 @@ void Loco::voieVariableModifiee(Voie *v)
     if(v == voieActuelle)
     {
         deraille = true;
-        vitesse = vitesseFuture = 0;
+        vitesse = 0;
         setRotation(rotation()+20.0);
     }
 }
-
-void Loco::adapterVitesse()
-{
-    if(inverser)
-    {
-        if (vitesse!=0)
-            vitesse--;
-        if(vitesse ==0)
-        {
-            this->setRotation(rotation()+180.0);
-            Voie* viensDe = voieSuivante;
-            voieSuivante = voieActuelle->getVoieSuivante(viensDe);
-            this->angleCumule -= 180.0;
-            inverser = false;
-        }
-    }
-    else
-    {
-        if(vitesse - vitesseFuture < 0)
-            vitesse++;
-        else if(vitesse - vitesseFuture > 0)
-            vitesse--;
-        else
-            timer->stop();
-    }
-}
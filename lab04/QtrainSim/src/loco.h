@@ -5,7 +5,6 @@
 #include <QAbstractGraphicsShapeItem>
 #include <QStaticText>
 #include <QPainter>
-#include <QTimer>
 
 #include "general.h"
 #include "voie.h"
@@ -51,10 +50,8 @@ public:
       */
     explicit Loco(int numLoco, QObject *parent = 0);
 
-    /** Permet de changer la vitesse de la loco.
-      * Le comportement dépend de l'option "Inertie" :
-      * avec l'inertie, le changement sera progressif.
-      * sans l'inertie, le changement sera immédiat.
+    /** Permet de changer la vitesse affichée de la loco. L'inertie est
+      * calculée par SimCore, dont la vue recopie la vitesse à chaque pas.
       * \param v la nouvelle vitesse de la loco.
       */
     void setVitesse(int v);
@@ -128,10 +125,16 @@ public:
     bool getActive();
 
     /** effectue la transition d'une voie à l'autre et repositionne la loco (corrige les imprécisions de calcul).
-      *
+      * Les contacts sont activés par SimCore, pas par l'affichage.
       */
     void avanceDUneVoie();
 
+    /** Appelée par la vue lorsque SimCore a fait passer la loco sur un contact.
+      * \param numContact le numéro du contact franchi.
+      * \param s le segment commençant à ce contact, nullptr s'il est inconnu.
+      */
+    void passeContact(int numContact, Segment* s);
+
     /** Fait avancer la loco d'une certaine distance.
       * \param distance la distance de laquelle il faut faire avancer la loco.
       */
@@ -178,10 +181,9 @@ public:
       */
     QPolygonF getContour();
 
-    /** Inverse le sens de la loco en conservant ou retrouvant la vitesse initiale.
-      * Le comportement dépend de l'option "Inertie" :
-      * avec l'inertie, le changement sera progressif.
-      * sans l'inertie, le changement sera immédiat.
+    /** Fait faire demi-tour à la loco, immédiatement. Appelée par la vue
+      * lorsque SimCore a retourné la loco, après l'arrêt progressif dû à
+      * l'inertie le cas échéant.
       */
     void inverserSens();
 
@@ -193,13 +195,6 @@ public:
     LocoCtrl *controller;
 signals:
 
-    /** signale que la loco a atteint un nouveau segment
-      * \param ctc1 le premier contact du segment
-      * \param ctc2 le deuxieme contact du segment
-      * \param l la loco emettrice du signal.
-      */
-    void nouveauSegment(Contact* ctc1, Contact* ctc2, Loco* l);
-
     /** Signale un déraillement.
       * \param l la loco emettrice du signal.
       */
@@ -215,26 +210,19 @@ public slots:
       * \param v la voie variable modifiée.
       */
     void voieVariableModifiee(Voie* v);
-
-    /** Reçoit le signal qu'il faut adapter la vitesse d'un incrément / décrément.
-      */
-    void adapterVitesse();
 private:
     panneauNumLoco* numLoco1;
     panneauNumLoco* numLoco2;
     qreal angleCumule;
     bool active;
     int vitesse;
-    int vitesseFuture;
     int direction;
     QColor couleur;
     Voie* voieActuelle;
     Voie* voieSuivante;
     Segment* segmentActuel;
     bool alerteProximite;
-    bool inverser;
     bool deraille;
-    QTimer* timer;
     QWaitCondition* VarCond;
     QMutex* mutex;
 };
@@ -13,11 +13,31 @@ using namespace std;
 //Header for CommandeTrain
 #include "commandetrain.h"
 
+//Header for the batch runner
+#include "batchrunner.h"
+
+//Header for the maquette generator
+#include "generateurmaquette.h"
+
 /**
  * Programme principal
  */
 int main(int argc, char *argv[])
 {
+    //Write a large generated maquette and exit
+    if (GenerateurMaquette::estDemande(argc, argv))
+    {
+        QCoreApplication app(argc,argv);
+        return GenerateurMaquette::executer(app.arguments());
+    }
+
+    //Run the control program without display
+    if (BatchRunner::estDemande(argc, argv))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+        QApplication app(argc,argv);
+        return BatchRunner::executer(app.arguments());
+    }
 
     QApplication app(argc,argv);
 
@@ -10,7 +10,9 @@
 #include <QDockWidget>
 #include <QCloseEvent>
 #include <QLineEdit>
+#include <QFileInfo>
 
+#include "batchrunner.h"
 #include "commandetrain.h"
 #include "mainwindow.h"
 #include "trainsimsettings.h"
@@ -572,25 +574,17 @@ void MainWindow::on_actionCharger_Maquette_triggered()
     chargerMaquette(filename);
 }
 
-void MainWindow::chargerMaquette(QString filename)
+bool MainWindow::lireFichierMaquette(QString filename, DescriptionMaquette &maquette)
 {
-    this->simView->viderMaquette();
-
-    // stockage temporaire des voies, avec les identifiants des voies a lier.
-    QMap <Voie*, QList<int>*> voiesALier;
-    // stockage temporaire des voies, indexees par identifiants.
-    QMap <int, Voie*> IDVoies;
-
     QStringList listeTemporaire;
-    QList<qreal>* infosVoieEnTraitement;
-    int IDvoie;
-    qreal directionVoieEnTraitement;
+    QList<double>* infosVoieEnTraitement;
 
     QFile fichier(filename);
 
     if(!fichier.open(QIODevice::ReadOnly | QIODevice::Text))
     {
         //declaration d'erreur.
+        return false;
     }
 
     QTextStream lecture(&fichier);
@@ -618,16 +612,9 @@ void MainWindow::chargerMaquette(QString filename)
 
     }
 
-    // lecture des informations relatives aux voies, creation des voies.
+    // lecture des informations relatives aux voies.
 
-    VoieDroite* vd;
-    VoieCourbe* vc;
-    VoieAiguillage* va;
-    VoieAiguillageEnroule* vae;
-    VoieAiguillageTriple* vat;
-    VoieCroisement* vcr;
-    VoieTraverseeJonction* vt;
-    VoieButtoir* vb;
+    maquette.voies.reserve(limite);
 
     for(int i =0; i < limite; i++)
     {
@@ -635,21 +622,22 @@ void MainWindow::chargerMaquette(QString filename)
 
         listeTemporaire = ligne.split(" ", QString::SkipEmptyParts);
 
-        IDvoie = listeTemporaire.at(0).toInt();
+        DescriptionVoie voie;
+        voie.id = listeTemporaire.at(0).toInt();
+        voie.type = listeTemporaire.at(1).toInt();
 
         //recuperation des infos de la voie en traitement.
-        infosVoieEnTraitement = infosVoies[listeTemporaire.at(1).toInt()];
+        infosVoieEnTraitement = infosVoies.value(voie.type, nullptr);
+
+        if(infosVoieEnTraitement == nullptr)
+        {
+            qDebug() << "Erreur de lecture de fichier : type de voie inconnu. " << voie.type;
+            return false;
+        }
 
         if(infosVoieEnTraitement->at(0) == 1.0)//voie Droite
         {
-            //Creation et insertion de la voie dans les stockages temporaires.
-            vd = new VoieDroite(infosVoieEnTraitement->at(1));
-            vd->setIdVoie(IDvoie);
-            IDVoies.insert(IDvoie, vd);
-            voiesALier.insert(vd, new QList<int>());
-            voiesALier[vd]->append(listeTemporaire.at(2).toInt());
-            voiesALier[vd]->append(listeTemporaire.at(3).toInt());
-            this->simView->addVoie(vd, listeTemporaire.at(0).toInt());
+            voie.liaisons << listeTemporaire.at(2).toInt() << listeTemporaire.at(3).toInt();
         }
         else if(infosVoieEnTraitement->at(0) == 2.0)//voie Courbe
         {
@@ -657,143 +645,72 @@ void MainWindow::chargerMaquette(QString filename)
             // NE CHANGER SOUS AUCUN PRETEXTE.
             if(listeTemporaire.at(4).toLower() == "gauche")
             {
-                directionVoieEnTraitement = 1.0;
+                voie.direction = 1.0;
             }
             else if(listeTemporaire.at(4).toLower() == "droite")
             {
-                directionVoieEnTraitement = -1.0;
+                voie.direction = -1.0;
             }
             else //en cas d'erreur dans le fichier...
                 qDebug() << "Erreur de lecture de fichier : fichier non standard (direction de courbe). ";
 
-            //Creation et insertion de la voie dans les stockages temporaires.
-            vc = new VoieCourbe(infosVoieEnTraitement->at(1), infosVoieEnTraitement->at(2), directionVoieEnTraitement);
-            vc->setIdVoie(IDvoie);
-            IDVoies.insert(IDvoie, vc);
-            voiesALier.insert(vc, new QList<int>());
-            voiesALier[vc]->append(listeTemporaire.at(2).toInt());
-            voiesALier[vc]->append(listeTemporaire.at(3).toInt());
-            this->simView->addVoie(vc, listeTemporaire.at(0).toInt());
+            voie.liaisons << listeTemporaire.at(2).toInt() << listeTemporaire.at(3).toInt();
         }
         else if(infosVoieEnTraitement->at(0) == 3.0)//voie Aiguillage
         {
             // les valeurs numeriques choisies pour representer gauche et droite sont utiles pour les calculs trigonometriques lors du placement des voies.
             // NE CHANGER SOUS AUCUN PRETEXTE.
             if(listeTemporaire.at(5).toLower() == "gauche")
-                directionVoieEnTraitement = 1.0;
+                voie.direction = 1.0;
             else if(listeTemporaire.at(5).toLower() == "droite")
-                directionVoieEnTraitement = -1.0;
+                voie.direction = -1.0;
             else
                 qDebug() << "Erreur de lecture de fichier : fichier non standard (direction d'aiguillage). ";
 
-            //Creation et insertion de la voie dans les stockages temporaires.
-            va = new VoieAiguillage(infosVoieEnTraitement->at(1), infosVoieEnTraitement->at(2), infosVoieEnTraitement->at(3), directionVoieEnTraitement);
-            va->setIdVoie(IDvoie);
-            IDVoies.insert(IDvoie, va);
-            voiesALier.insert(va, new QList<int>());
-            voiesALier[va]->append(listeTemporaire.at(2).toInt());
-            voiesALier[va]->append(listeTemporaire.at(3).toInt());
-            voiesALier[va]->append(listeTemporaire.at(4).toInt());
-            this->simView->addVoie(va, listeTemporaire.at(0).toInt());
-        }
-        else if(infosVoieEnTraitement->at(0) == 4.0)//voie Croisement
-        {
-            //Creation et insertion de la voie dans les stockages temporaires.
-            vcr = new VoieCroisement(infosVoieEnTraitement->at(1), infosVoieEnTraitement->at(2));
-            vcr->setIdVoie(IDvoie);
-            IDVoies.insert(IDvoie, vcr);
-            voiesALier.insert(vcr, new QList<int>());
-            voiesALier[vcr]->append(listeTemporaire.at(2).toInt());
-            voiesALier[vcr]->append(listeTemporaire.at(3).toInt());
-            voiesALier[vcr]->append(listeTemporaire.at(4).toInt());
-            voiesALier[vcr]->append(listeTemporaire.at(5).toInt());
-            this->simView->addVoie(vcr, listeTemporaire.at(0).toInt());
+            voie.liaisons << listeTemporaire.at(2).toInt() << listeTemporaire.at(3).toInt()
+                          << listeTemporaire.at(4).toInt();
         }
-        else if(infosVoieEnTraitement->at(0) == 5.0)//voie Traversee-Jonction
+        else if(infosVoieEnTraitement->at(0) == 4.0 ||//voie Croisement
+                infosVoieEnTraitement->at(0) == 5.0 ||//voie Traversee-Jonction
+                infosVoieEnTraitement->at(0) == 8.0)//voie Aiguillage Triple
         {
-            //Creation et insertion de la voie dans les stockages temporaires.
-            vt= new VoieTraverseeJonction(infosVoieEnTraitement->at(1), infosVoieEnTraitement->at(2), infosVoieEnTraitement->at(3));
-            vt->setIdVoie(IDvoie);
-            IDVoies.insert(IDvoie, vt);
-            voiesALier.insert(vt, new QList<int>());
-            voiesALier[vt]->append(listeTemporaire.at(2).toInt());
-            voiesALier[vt]->append(listeTemporaire.at(3).toInt());
-            voiesALier[vt]->append(listeTemporaire.at(4).toInt());
-            voiesALier[vt]->append(listeTemporaire.at(5).toInt());
-            this->simView->addVoie(vt, listeTemporaire.at(0).toInt());
+            voie.liaisons << listeTemporaire.at(2).toInt() << listeTemporaire.at(3).toInt()
+                          << listeTemporaire.at(4).toInt() << listeTemporaire.at(5).toInt();
         }
         else if(infosVoieEnTraitement->at(0) == 6.0)//voie Buttoir
         {
-            //Creation et insertion de la voie dans les stockages temporaires.
-            vb = new VoieButtoir(infosVoieEnTraitement->at(1));
-            vb->setIdVoie(IDvoie);
-            IDVoies.insert(IDvoie, vb);
-            voiesALier.insert(vb, new QList<int>());
-            voiesALier[vb]->append(listeTemporaire.at(2).toInt());
-            this->simView->addVoie(vb, listeTemporaire.at(0).toInt());
+            voie.liaisons << listeTemporaire.at(2).toInt();
         }
         else if(infosVoieEnTraitement->at(0) == 7.0)//voie Aiguillage Enroule
         {
             // les valeurs numeriques choisies pour representer gauche et droite sont utiles pour les calculs trigonometriques lors du placement des voies.
             // NE CHANGER SOUS AUCUN PRETEXTE.
             if(listeTemporaire.at(5).toLower() == "gauche")
-                directionVoieEnTraitement = 1.0;
+                voie.direction = 1.0;
             else if(listeTemporaire.at(5).toLower() == "droite")
-                directionVoieEnTraitement = -1.0;
+                voie.direction = -1.0;
             else
                 qDebug() << "Erreur de lecture de fichier : fichier non standard (direction d'aiguillage). ";
 
-            //Creation et insertion de la voie dans les stockages temporaires.
-            vae = new VoieAiguillageEnroule(infosVoieEnTraitement->at(1), infosVoieEnTraitement->at(2), infosVoieEnTraitement->at(3), directionVoieEnTraitement);
-            vae->setIdVoie(IDvoie);
-            IDVoies.insert(IDvoie, vae);
-            voiesALier.insert(vae, new QList<int>());
-            voiesALier[vae]->append(listeTemporaire.at(2).toInt());
-            voiesALier[vae]->append(listeTemporaire.at(4).toInt()); //ordre inversé, pour la cohérence du code...
-            voiesALier[vae]->append(listeTemporaire.at(3).toInt());
-            this->simView->addVoie(vae, listeTemporaire.at(0).toInt());
-        }
-        else if(infosVoieEnTraitement->at(0) == 8.0)//voie Aiguillage Triple
-        {
-            //Creation et insertion de la voie dans les stockages temporaires.
-            vat = new VoieAiguillageTriple(infosVoieEnTraitement->at(1), infosVoieEnTraitement->at(2), infosVoieEnTraitement->at(3));
-            vat->setIdVoie(IDvoie);
-            IDVoies.insert(IDvoie, vat);
-            voiesALier.insert(vat, new QList<int>());
-            voiesALier[vat]->append(listeTemporaire.at(2).toInt());
-            voiesALier[vat]->append(listeTemporaire.at(3).toInt());
-            voiesALier[vat]->append(listeTemporaire.at(4).toInt());
-            voiesALier[vat]->append(listeTemporaire.at(5).toInt());
-            this->simView->addVoie(vat, listeTemporaire.at(0).toInt());
+            voie.liaisons << listeTemporaire.at(2).toInt()
+                          << listeTemporaire.at(4).toInt() //ordre inversé, pour la cohérence du code...
+                          << listeTemporaire.at(3).toInt();
         }
-    }
-    //finalisation de la creation des voies.
 
-    for(int i = 1; i <= IDVoies.size(); i++)
-    {
-        for(int j = 0; j < voiesALier[IDVoies[i]]->length(); j++)
-        {
-            IDVoies[i]->lier(IDVoies[voiesALier[IDVoies[i]]->at(j)], j);
-        }
+        maquette.voies.append(voie);
     }
 
     //debut de la lecture des contacts.
 
     limite = lecture.readLine().toInt();
 
-    Contact* c;
-
     for(int i=0; i < limite;i++)
     {
         ligne = lecture.readLine();
 
         listeTemporaire = ligne.split(" ", QString::SkipEmptyParts);
 
-        //creation des contacts.
-        c = new Contact(listeTemporaire.at(0).toInt(), listeTemporaire.at(1).toInt());
-
-        IDVoies[listeTemporaire.at(1).toInt()]->setContact(c);
-        this->simView->addContact(c, listeTemporaire.at(0).toInt());
+        maquette.contacts.append(qMakePair(listeTemporaire.at(0).toInt(), listeTemporaire.at(1).toInt()));
     }
 
     //debut de la lecture des aiguillages.
@@ -806,34 +723,193 @@ void MainWindow::chargerMaquette(QString filename)
 
         listeTemporaire = ligne.split(" ", QString::SkipEmptyParts);
 
-        VoieVariable *v=dynamic_cast<VoieVariable *>(IDVoies[listeTemporaire.at(1).toInt()]);
+        maquette.voiesVariables.append(qMakePair(listeTemporaire.at(0).toInt(), listeTemporaire.at(1).toInt()));
+    }
+
+    //indication de la premiere voie a poser.
+
+    maquette.premiereVoie = lecture.readLine().toInt();
+
+    return true;
+}
+
+Voie* MainWindow::creerVoie(const DescriptionVoie &description)
+{
+    QList<double>* infos = infosVoies.value(description.type, nullptr);
+
+    if(infos == nullptr)
+        return nullptr;
+
+    if(infos->at(0) == 1.0)//voie Droite
+        return new VoieDroite(infos->at(1));
+    else if(infos->at(0) == 2.0)//voie Courbe
+        return new VoieCourbe(infos->at(1), infos->at(2), description.direction);
+    else if(infos->at(0) == 3.0)//voie Aiguillage
+        return new VoieAiguillage(infos->at(1), infos->at(2), infos->at(3), description.direction);
+    else if(infos->at(0) == 4.0)//voie Croisement
+        return new VoieCroisement(infos->at(1), infos->at(2));
+    else if(infos->at(0) == 5.0)//voie Traversee-Jonction
+        return new VoieTraverseeJonction(infos->at(1), infos->at(2), infos->at(3));
+    else if(infos->at(0) == 6.0)//voie Buttoir
+        return new VoieButtoir(infos->at(1));
+    else if(infos->at(0) == 7.0)//voie Aiguillage Enroule
+        return new VoieAiguillageEnroule(infos->at(1), infos->at(2), infos->at(3), description.direction);
+    else if(infos->at(0) == 8.0)//voie Aiguillage Triple
+        return new VoieAiguillageTriple(infos->at(1), infos->at(2), infos->at(3));
+
+    return nullptr;
+}
+
+bool MainWindow::creerVoies(const DescriptionMaquette &maquette, bool restaurerGeometrie, QMap<int, Voie*> &IDVoies)
+{
+    // creation des voies.
+
+    foreach(const DescriptionVoie &description, maquette.voies)
+    {
+        Voie* v = creerVoie(description);
+        if(v == nullptr)
+            continue;
+        v->setIdVoie(description.id);
+        IDVoies.insert(description.id, v);
+    }
+
+    //finalisation de la creation des voies.
+
+    foreach(const DescriptionVoie &description, maquette.voies)
+    {
+        for(int j = 0; j < description.liaisons.size(); j++)
+        {
+            IDVoies.value(description.id)->lier(IDVoies.value(description.liaisons.at(j)), j);
+        }
+    }
+
+    //creation des contacts, détruits avec leur voie.
+
+    for(const QPair<qint32, qint32> &contact : maquette.contacts)
+    {
+        IDVoies.value(contact.second)->setContact(new Contact(contact.first, contact.second));
+    }
+
+    if(restaurerGeometrie)
+    {
+        foreach(const DescriptionVoie &description, maquette.voies)
+        {
+            if(!IDVoies.value(description.id)->restaurerGeometrie(description.geometrie))
+            {
+                qDeleteAll(IDVoies);
+                IDVoies.clear();
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void MainWindow::chargerMaquette(QString filename)
+{
+    this->simView->viderMaquette();
+
+    QString fichierInfosVoies = DATADIR+"/infosVoies.txt";
+    DescriptionMaquette maquette;
+
+    // stockage temporaire des voies, indexees par identifiants.
+    QMap <int, Voie*> IDVoies;
+
+    // La maquette compilée lors d'un chargement précédent évite la lecture du
+    // texte, la pose des voies et l'exploration contact à contact.
+    bool depuisCache = CacheMaquette::charger(filename, fichierInfosVoies, maquette);
 
-        this->simView->addVoieVariable(v, listeTemporaire.at(0).toInt());
+    if(depuisCache && !creerVoies(maquette, true, IDVoies))
+    {
+        // Cache incohérent avec la maquette : on repart du fichier texte, qui
+        // remplacera le cache. Rien n'a encore été ajouté à la vue.
+        qDebug() << "Cache de maquette invalide, relecture de " << filename;
+        if(!QFile::remove(CacheMaquette::cheminCache(filename)))
+            qDebug() << "Impossible de supprimer le cache " << CacheMaquette::cheminCache(filename);
+        depuisCache = false;
+        maquette = DescriptionMaquette();
+    }
 
-        v->setNumVoieVariable(listeTemporaire.at(0).toInt());
+    if(!depuisCache)
+    {
+        if(!lireFichierMaquette(filename, maquette))
+        {
+            qDebug() << "Erreur de lecture de fichier : " << filename;
+            this->maquetteFinie.release();
+            return;
+        }
+        creerVoies(maquette, false, IDVoies);
+    }
+
+    // ajout des voies, contacts et aiguillages à la vue.
 
+    foreach(const DescriptionVoie &description, maquette.voies)
+    {
+        if(IDVoies.contains(description.id))
+            this->simView->addVoie(IDVoies.value(description.id), description.id);
+    }
+
+    for(const QPair<qint32, qint32> &contact : maquette.contacts)
+    {
+        this->simView->addContact(IDVoies.value(contact.second)->getContact(), contact.first);
+    }
+
+    for(const QPair<qint32, qint32> &voieVariable : maquette.voiesVariables)
+    {
+        VoieVariable *v=dynamic_cast<VoieVariable *>(IDVoies.value(voieVariable.second));
+
+        this->simView->addVoieVariable(v, voieVariable.first);
+
+        v->setNumVoieVariable(voieVariable.first);
     }
 
     //indication de la premiere voie a poser.
 
-    Voie * premiereVoie = IDVoies[lecture.readLine().toInt()];
+    this->simView->setPremiereVoie(IDVoies.value(maquette.premiereVoie));
 
-    this->simView->setPremiereVoie(premiereVoie);
+    this->simView->construireMaquette(depuisCache);
 
-    this->simView->construireMaquette();
+    if(depuisCache)
+    {
+        foreach(const DescriptionSegment &segment, maquette.segments)
+        {
+            QList<Voie*> voies;
+            for(qint32 id : segment.voies)
+                voies.append(IDVoies.value(id));
+
+            this->simView->ajouterSegment(new Segment(this->simView->getContact(segment.contact1),
+                                                      this->simView->getContact(segment.contact2),
+                                                      voies));
+        }
+    }
+    else
+    {
+        this->simView->genererSegments();
 
-    this->simView->genererSegments();
+        // compilation de la maquette pour les chargements suivants.
+        for(DescriptionVoie &description : maquette.voies)
+            description.geometrie = IDVoies.value(description.id)->getGeometrie();
+
+        foreach(Segment* s, this->simView->getSegments())
+        {
+            DescriptionSegment segment;
+            segment.contact1 = s->getContact1()->getNumContact();
+            segment.contact2 = s->getContact2() == nullptr ? -1 : s->getContact2()->getNumContact();
+            foreach(Voie* v, s->getVoies())
+                segment.voies.append(v->getIdVoie());
+            maquette.segments.append(segment);
+        }
+
+        CacheMaquette::sauver(filename, fichierInfosVoies, maquette);
+    }
 
     this->simView->zoomFit();
 
     this->simView->repaint();
 
-    // On détruit la map qui contient des pointeurs sur des QList
-    QMapIterator<Voie*, QList<int>*> it(voiesALier);
-    while (it.hasNext()) {
-        it.next();
-        delete it.value();
-    }
+    if (BatchRunner::getInstance() != nullptr)
+        BatchRunner::getInstance()->demarrer(simView);
 
     this->maquetteFinie.release();
 }
@@ -849,6 +925,14 @@ void MainWindow::selectionMaquette(QString maquette)
 
     MaquetteManager manager;
 
+    // Fichier de maquette donné directement, en exécution sans affichage
+    if (BatchRunner::estActif() && QFileInfo(maquette).isFile())
+    {
+        chargerMaquette(maquette);
+        semWaitMaquette.release();
+        return;
+    }
+
     QStringList list=manager.nomMaquettes();
     if (!list.contains(maquette))
     {
@@ -863,6 +947,11 @@ void MainWindow::selectionMaquette(QString maquette)
             foreach(QString maq,list)
                 message+=QString("\n\t%1").arg(maq);
         }
+        if (BatchRunner::estActif())
+        {
+            fprintf(stderr, "%s\n", qPrintable(message));
+            exit(BatchRunner::ERREUR);
+        }
         QMessageBox::warning(0,"La maquette n'existe pas",message);
         exit(1);
     }
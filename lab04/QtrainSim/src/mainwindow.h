@@ -21,6 +21,7 @@
 #include "simview.h"
 #include "contact.h"
 #include "connect.h"
+#include "cachemaquette.h"
 
 template< class Elem = char, class Tr = std::char_traits< Elem > >
  class StdRedirector : public std::basic_streambuf< Elem, Tr >
@@ -135,6 +136,30 @@ public:
       */
     void chargerMaquette(QString filename);
 
+    /** Lit le fichier texte d'une maquette.
+      * \param filename le nom du fichier.
+      * \param maquette la maquette lue (retour).
+      * \return faux si le fichier ne peut être lu.
+      */
+    bool lireFichierMaquette(QString filename, DescriptionMaquette &maquette);
+
+    /** Crée les voies d'une maquette, les lie et leur pose les contacts, sans
+      * rien ajouter à la vue.
+      * \param maquette la maquette à créer.
+      * \param restaurerGeometrie vrai pour reprendre la géométrie compilée
+      *        dans la maquette, lue depuis le cache.
+      * \param IDVoies les voies créées, indexées par identifiant (retour).
+      * \return faux si la géométrie ne correspond pas aux voies ; celles-ci
+      *         sont alors détruites et IDVoies est vide.
+      */
+    bool creerVoies(const DescriptionMaquette &maquette, bool restaurerGeometrie, QMap<int, Voie*> &IDVoies);
+
+    /** Crée la voie décrite, selon son type dans infosVoies.
+      * \param description la voie lue dans la maquette.
+      * \return la voie créée, nullptr si son type est inconnu.
+      */
+    Voie* creerVoie(const DescriptionVoie &description);
+
     void createActions();
     void createMenus();
     void updateMenus();
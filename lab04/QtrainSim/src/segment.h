@@ -39,6 +39,15 @@ public:
       * \return vrai si le segment relie c1 et c2, faux sinon.
       */
     bool relie(Contact* c1, Contact* c2);
+
+    /** retourne le premier contact du segment. */
+    Contact* getContact1() const;
+
+    /** retourne le second contact du segment, nullptr s'il se termine sur un buttoir. */
+    Contact* getContact2() const;
+
+    /** retourne les voies du segment, du premier contact au second. */
+    const QList<Voie*>& getVoies() const;
 signals:
 
 public slots:
@@ -0,0 +1,344 @@
+#include "simcore.h"
+#include "voie.h"
+
+/** Nombre maximal de liaisons d'une voie (traversée jonction, aiguillage triple). */
+static const int MAX_LIAISONS = 4;
+
+SimCore::SimCore()
+{
+    this->nbPas = 0;
+    this->reste = 0.0;
+}
+
+void SimCore::setTopologie(const QMap<int, VoieSim> &voies)
+{
+    this->voies.clear();
+    if(!voies.isEmpty() && voies.firstKey() >= 0)
+        this->voies.resize(voies.lastKey() + 1);
+    for(auto it = voies.cbegin(); it != voies.cend(); ++it)
+        if(it.key() >= 0)
+            this->voies[it.key()] = it.value();
+    this->locos.clear();
+    this->numerosVoies.clear();
+    this->nbPas = 0;
+    this->reste = 0.0;
+}
+
+void SimCore::chargerTopologie(const QMap<int, Voie*> &voies)
+{
+    QMap<int, VoieSim> topologie;
+
+    // Les numéros doivent être connus pour décrire les liaisons
+    numerosVoies.clear();
+    for(auto it = voies.cbegin(); it != voies.cend(); ++it)
+        numerosVoies.insert(it.value(), it.key());
+
+    for(auto it = voies.cbegin(); it != voies.cend(); ++it)
+        topologie.insert(it.key(), decrireVoie(it.value()));
+
+    QMap<Voie*, int> numeros = numerosVoies;
+    setTopologie(topologie);
+    numerosVoies = numeros;
+}
+
+VoieSim SimCore::decrireVoie(Voie *v) const
+{
+    VoieSim voie;
+
+    voie.longueur = v->getLongueurAParcourir();
+    if(v->getContact() != nullptr)
+        voie.contact = v->getContact()->getNumContact();
+
+    for(int n = 0; n < MAX_LIAISONS; n++)
+    {
+        Voie* voisine = v->getVoieVoisineDOrdre(n);
+        if(voisine == nullptr)
+            continue;
+        Voie* suivante = v->getVoieSuivante(voisine);
+        voie.voisines.append(numerosVoies.value(voisine, -1));
+        voie.sorties.append(suivante == nullptr ? -1 : numerosVoies.value(suivante, -1));
+    }
+
+    return voie;
+}
+
+void SimCore::actualiserVoie(Voie *v)
+{
+    if(!numerosVoies.contains(v))
+        return;
+
+    modifierVoie(numerosVoies.value(v), decrireVoie(v));
+}
+
+void SimCore::modifierVoie(int numVoie, const VoieSim &voie)
+{
+    if(numVoie < 0)
+        return;
+    if(numVoie >= voies.size())
+        voies.resize(numVoie + 1);
+    voies[numVoie] = voie;
+
+    // Même comportement que Loco::voieVariableModifiee
+    for(LocoSim &l : locos)
+    {
+        if(l.voie == numVoie)
+        {
+            l.deraille = true;
+            l.vitesse = l.vitesseFuture = 0;
+        }
+    }
+}
+
+void SimCore::placerLoco(int numLoco, int voie, int voieSuivante)
+{
+    LocoSim &l = locos[numLoco];
+
+    l.numLoco = numLoco;
+    l.voie = voie;
+    l.voieSuivante = voieSuivante;
+    l.parcouru = getVoie(voie).longueur / 2.0;
+}
+
+void SimCore::setVitesse(int numLoco, int vitesse, bool inertie)
+{
+    if(!locos.contains(numLoco))
+        return;
+
+    LocoSim &l = locos[numLoco];
+
+    l.vitesseFuture = vitesse;
+    l.inertie = inertie;
+    if(inertie)
+        l.attenteInertie = INERTIE_LOCO / 1000.0;
+    else
+        l.vitesse = vitesse;
+}
+
+void SimCore::inverserSens(int numLoco, bool inertie)
+{
+    if(!locos.contains(numLoco))
+        return;
+
+    LocoSim &l = locos[numLoco];
+
+    if(inertie)
+    {
+        l.inverser = true;
+        l.inertie = true;
+        l.attenteInertie = INERTIE_LOCO / 1000.0;
+    }
+    else
+    {
+        retourner(l);
+    }
+}
+
+void SimCore::setActive(int numLoco, bool active)
+{
+    if(locos.contains(numLoco))
+        locos[numLoco].active = active;
+}
+
+void SimCore::setObservateurContact(std::function<void(int, int)> observateur)
+{
+    this->observateurContact = observateur;
+}
+
+const VoieSim& SimCore::getVoie(int numVoie) const
+{
+    static const VoieSim voieVide;
+
+    if(numVoie < 0 || numVoie >= voies.size())
+        return voieVide;
+    return voies.at(numVoie);
+}
+
+int SimCore::sortie(int voie, int voieArrivee) const
+{
+    const VoieSim &v = getVoie(voie);
+
+    int ordre = v.voisines.indexOf(voieArrivee);
+    return ordre < 0 ? -1 : v.sorties.at(ordre);
+}
+
+void SimCore::retourner(LocoSim &l)
+{
+    int viensDe = l.voieSuivante;
+    l.voieSuivante = sortie(l.voie, viensDe);
+    l.parcouru = getVoie(l.voie).longueur - l.parcouru;
+    l.nbRetournements++;
+}
+
+void SimCore::adapterVitesse(LocoSim &l)
+{
+    // Reproduit le QTimer de Loco, cadencé ici en temps simulé
+    l.attenteInertie -= PAS_TEMPS;
+    if(l.attenteInertie > 0.0)
+        return;
+    l.attenteInertie += INERTIE_LOCO / 1000.0;
+
+    if(l.inverser)
+    {
+        if(l.vitesse != 0)
+            l.vitesse--;
+        if(l.vitesse == 0)
+        {
+            retourner(l);
+            l.inverser = false;
+        }
+    }
+    else
+    {
+        if(l.vitesse < l.vitesseFuture)
+            l.vitesse++;
+        else if(l.vitesse > l.vitesseFuture)
+            l.vitesse--;
+        else
+            l.inertie = false;
+    }
+}
+
+void SimCore::changerDeVoie(LocoSim &l)
+{
+    int viensDe = l.voie;
+
+    l.parcouru -= getVoie(l.voie).longueur;
+    l.voie = l.voieSuivante;
+    l.voieSuivante = sortie(l.voie, viensDe);
+
+    int contact = getVoie(l.voie).contact;
+    if(contact >= 0 && observateurContact)
+        observateurContact(l.numLoco, contact);
+}
+
+void SimCore::pas()
+{
+    for(LocoSim &l : locos)
+    {
+        if(!l.active || l.voie < 0)
+            continue;
+
+        if(l.inertie || l.inverser)
+            adapterVitesse(l);
+
+        if(l.vitesse == 0)
+            continue;
+
+        qreal distance = l.vitesse * 1000.0 * FACTEUR_VITESSE * PAS_TEMPS;
+        l.parcouru += distance;
+        l.parcouruTotal += distance;
+
+        while(l.parcouru >= getVoie(l.voie).longueur)
+        {
+            // Buttoir : la loco reste en bout de voie
+            if(l.voieSuivante < 0)
+            {
+                l.parcouruTotal -= l.parcouru - getVoie(l.voie).longueur;
+                l.parcouru = getVoie(l.voie).longueur;
+                break;
+            }
+            changerDeVoie(l);
+        }
+    }
+
+    nbPas++;
+}
+
+int SimCore::avancer(qreal secondes)
+{
+    int nb = 0;
+
+    reste += secondes;
+    while(reste >= PAS_TEMPS)
+    {
+        pas();
+        reste -= PAS_TEMPS;
+        nb++;
+    }
+
+    return nb;
+}
+
+InstantaneSim SimCore::instantane() const
+{
+    InstantaneSim instantane;
+
+    instantane.pas = nbPas;
+    instantane.temps = nbPas * PAS_TEMPS;
+    instantane.locos = locos;
+
+    return instantane;
+}
+
+qint64 SimCore::getNbPas() const
+{
+    return nbPas;
+}
+
+const QMap<int, LocoSim>& SimCore::getLocos() const
+{
+    return locos;
+}
+
+/** distance entre une loco et l'extrémité de sa voie liée à une voie donnée. */
+static qreal distanceExtremite(const LocoSim &l, qreal longueur, int extremite)
+{
+    return l.voieSuivante == extremite ? longueur - l.parcouru : l.parcouru;
+}
+
+static void ajouterPaire(QList<QPair<int, int>> &paires, int a, int b)
+{
+    QPair<int, int> paire = qMakePair(qMin(a, b), qMax(a, b));
+    if(!paires.contains(paire))
+        paires.append(paire);
+}
+
+void SimCore::chercherCollisions(const LocoSim &l, int voie, qreal distance, QList<QPair<int, int>> &paires) const
+{
+    int precedente = l.voie;
+
+    while(voie >= 0 && distance < LONGUEUR_LOCO)
+    {
+        const VoieSim &v = getVoie(voie);
+
+        for(const LocoSim &autre : locos)
+        {
+            if(autre.numLoco != l.numLoco && autre.voie == voie &&
+               distance + distanceExtremite(autre, v.longueur, precedente) < LONGUEUR_LOCO)
+                ajouterPaire(paires, l.numLoco, autre.numLoco);
+        }
+
+        distance += v.longueur;
+        int suivante = sortie(voie, precedente);
+        precedente = voie;
+        voie = suivante;
+    }
+}
+
+QList<QPair<int, int>> SimCore::collisions() const
+{
+    QList<QPair<int, int>> paires;
+
+    for(const LocoSim &l : locos)
+    {
+        if(l.voie < 0)
+            continue;
+
+        const VoieSim &v = getVoie(l.voie);
+
+        // Positions mesurées depuis l'extrémité vers laquelle l se dirige
+        qreal position = v.longueur - l.parcouru;
+        for(const LocoSim &autre : locos)
+        {
+            if(autre.numLoco > l.numLoco && autre.voie == l.voie &&
+               qAbs(position - distanceExtremite(autre, v.longueur, l.voieSuivante)) < LONGUEUR_LOCO)
+                ajouterPaire(paires, l.numLoco, autre.numLoco);
+        }
+
+        // Voies voisines, devant puis derrière la loco
+        chercherCollisions(l, l.voieSuivante, v.longueur - l.parcouru, paires);
+        chercherCollisions(l, sortie(l.voie, l.voieSuivante), l.parcouru, paires);
+    }
+
+    return paires;
+}
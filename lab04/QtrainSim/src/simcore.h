@@ -0,0 +1,194 @@
+#ifndef SIMCORE_H
+#define SIMCORE_H
+
+#include <functional>
+
+#include <QList>
+#include <QMap>
+#include <QPair>
+#include <QVector>
+
+#include "general.h"
+
+class Voie;
+
+/** Voie du réseau telle que vue par le coeur de simulation : sa longueur,
+  * son contact et, pour chaque voie d'arrivée, la voie de sortie.
+  */
+struct VoieSim
+{
+    qreal longueur = 0.0;
+    /** numéro du contact porté par la voie, -1 si aucun. */
+    int contact = -1;
+    /** numéros des voies liées, dans l'ordre des liaisons. */
+    QVector<int> voisines;
+    /** sorties[i] est la voie de sortie en arrivant de voisines[i], -1 pour un buttoir. */
+    QVector<int> sorties;
+};
+
+/** Etat d'une loco, repérée par sa voie et la distance parcourue depuis
+  * l'entrée dans celle-ci.
+  */
+struct LocoSim
+{
+    int numLoco = 0;
+    int voie = -1;
+    int voieSuivante = -1;
+    qreal parcouru = 0.0;
+    /** distance totale parcourue depuis le placement de la loco. */
+    qreal parcouruTotal = 0.0;
+    int vitesse = 0;
+    int vitesseFuture = 0;
+    bool inertie = false;
+    bool inverser = false;
+    bool active = true;
+    bool deraille = false;
+    /** temps simulé restant avant le prochain palier de vitesse. */
+    qreal attenteInertie = 0.0;
+    /** nombre de demi-tours effectués, pour que la vue les reproduise. */
+    int nbRetournements = 0;
+};
+
+/** Etat complet de la simulation à un pas donné. */
+struct InstantaneSim
+{
+    qint64 pas = 0;
+    qreal temps = 0.0;
+    QMap<int, LocoSim> locos;
+};
+
+/** Coeur de simulation sans affichage.
+  * Le réseau est réduit à un graphe de voies et les locos avancent par pas
+  * de temps fixes, indépendamment de tout QGraphicsScene. La simulation peut
+  * ainsi tourner sans fenêtre et plus vite que le temps réel ; la vue ne fait
+  * que lire des instantanés.
+  */
+class SimCore
+{
+public:
+    /** Durée simulée d'un pas, en secondes. */
+    static constexpr qreal PAS_TEMPS = 1.0 / FRAME_RATE;
+
+    SimCore();
+
+    /** Remplace le réseau simulé. Les locos sont retirées.
+      * \param voies les voies, indexées par leur numéro.
+      */
+    void setTopologie(const QMap<int, VoieSim> &voies);
+
+    /** Construit le réseau simulé à partir des voies de la maquette chargée.
+      * \param voies les voies de la maquette, indexées par leur numéro.
+      */
+    void chargerTopologie(const QMap<int, Voie*> &voies);
+
+    /** Relit les sorties d'une voie variable après un changement d'état.
+      * Une loco posée sur cette voie déraille.
+      * \param v la voie variable modifiée.
+      */
+    void actualiserVoie(Voie* v);
+
+    /** Change l'état d'une voie du réseau simulé, sans passer par la maquette.
+      * Une loco posée sur cette voie déraille.
+      * \param numVoie le numéro de la voie.
+      * \param voie les nouvelles caractéristiques de la voie.
+      */
+    void modifierVoie(int numVoie, const VoieSim &voie);
+
+    /** Pose une loco au milieu d'une voie.
+      * \param numLoco le numéro de la loco.
+      * \param voie la voie sur laquelle la loco est posée.
+      * \param voieSuivante la voie vers laquelle la loco est dirigée.
+      */
+    void placerLoco(int numLoco, int voie, int voieSuivante);
+
+    /** Change la vitesse d'une loco.
+      * \param numLoco le numéro de la loco.
+      * \param vitesse la nouvelle vitesse.
+      * \param inertie vrai si le changement doit être progressif.
+      */
+    void setVitesse(int numLoco, int vitesse, bool inertie);
+
+    /** Inverse le sens d'une loco.
+      * \param numLoco le numéro de la loco.
+      * \param inertie vrai si la loco doit d'abord s'arrêter progressivement.
+      */
+    void inverserSens(int numLoco, bool inertie);
+
+    /** Active ou désactive une loco. Une loco inactive n'avance plus.
+      * \param numLoco le numéro de la loco.
+      * \param active la nouvelle valeur.
+      */
+    void setActive(int numLoco, bool active);
+
+    /** Fonction appelée à chaque passage d'une loco sur un contact.
+      * \param observateur reçoit le numéro de la loco puis celui du contact.
+      */
+    void setObservateurContact(std::function<void(int, int)> observateur);
+
+    /** Effectue un pas de simulation. */
+    void pas();
+
+    /** Effectue autant de pas que nécessaire pour simuler une durée. La
+      * fraction de pas restante est reportée sur l'appel suivant.
+      * \param secondes la durée à simuler.
+      * \return le nombre de pas effectués.
+      */
+    int avancer(qreal secondes);
+
+    /** Retourne l'état courant de la simulation.
+      * \return l'instantané courant.
+      */
+    InstantaneSim instantane() const;
+
+    /** Retourne le nombre de pas effectués depuis le chargement du réseau. */
+    qint64 getNbPas() const;
+
+    /** Retourne l'état des locos, sans copie.
+      * \return les locos, indexées par leur numéro.
+      */
+    const QMap<int, LocoSim>& getLocos() const;
+
+    /** Retourne les paires de locos dont les centres sont, le long des voies,
+      * à moins d'une longueur de loco l'un de l'autre.
+      * \return les paires (plus petit numéro, plus grand numéro) en collision.
+      */
+    QList<QPair<int, int>> collisions() const;
+
+private:
+    /** fait passer une loco sur sa voie suivante. */
+    void changerDeVoie(LocoSim &l);
+
+    /** applique un palier de vitesse à une loco soumise à l'inertie. */
+    void adapterVitesse(LocoSim &l);
+
+    /** oriente la loco vers l'autre extrémité de sa voie. */
+    void retourner(LocoSim &l);
+
+    /** retourne la sortie d'une voie en arrivant d'une voie donnée, -1 si aucune. */
+    int sortie(int voie, int voieArrivee) const;
+
+    /** retourne la description simulée d'une voie de la maquette. */
+    VoieSim decrireVoie(Voie* v) const;
+
+    /** cherche les locos proches de l en parcourant les voies depuis une de ses extrémités.
+      * \param l la loco de départ.
+      * \param voie la voie à l'extrémité de la voie de l.
+      * \param distance la distance entre le centre de l et cette extrémité.
+      * \param paires les paires en collision (retour).
+      */
+    void chercherCollisions(const LocoSim &l, int voie, qreal distance, QList<QPair<int, int>> &paires) const;
+
+    /** retourne la voie de numéro donné, une voie vide s'il n'existe pas. */
+    const VoieSim& getVoie(int numVoie) const;
+
+    /** voies indexées par leur numéro, les numéros inutilisés restant vides. */
+    QVector<VoieSim> voies;
+    QMap<int, LocoSim> locos;
+    /** numéro de chaque voie de la maquette chargée. */
+    QMap<Voie*, int> numerosVoies;
+    std::function<void(int, int)> observateurContact;
+    qint64 nbPas;
+    qreal reste;
+};
+
+#endif // SIMCORE_H
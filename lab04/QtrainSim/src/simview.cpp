@@ -1,4 +1,6 @@
 #include "simview.h"
+#include "batchrunner.h"
+#include "trainsimsettings.h"
 
 SimView::SimView(QWidget */*parent*/)
     : QGraphicsView()
@@ -8,6 +10,14 @@ SimView::SimView(QWidget */*parent*/)
     this->setRenderHints(QPainter::Antialiasing);
     timer = new QTimer(this);
     CONNECT(timer, SIGNAL(timeout()), this, SLOT(animationStep()));
+
+    // Les contacts sont franchis dans le coeur de simulation; les locos
+    // affichées ne font que suivre sa position. Sans affichage, BatchRunner
+    // remplace cet observateur.
+    simCore.setObservateurContact([this](int numLoco, int numContact)
+    {
+        contactFranchi(numLoco, numContact);
+    });
 }
 
 void SimView::redraw()
@@ -15,6 +25,11 @@ void SimView::redraw()
     scene->update(sceneRect());
 }
 
+SimCore* SimView::getSimCore()
+{
+    return &simCore;
+}
+
 void SimView::addVoie(Voie *v, int ID)
 {
     this->Voies.insert(ID, v);
@@ -25,6 +40,9 @@ void SimView::addVoie(Voie *v, int ID)
 void SimView::addContact(Contact *c, int ID)
 {
     this->contacts.insert(ID, c);
+    if(ID >= contactsParNumero.size())
+        contactsParNumero.resize(ID + 1);
+    contactsParNumero[ID] = c;
 }
 
 void SimView::addVoieVariable(VoieVariable *vv, int ID)
@@ -43,23 +61,45 @@ void SimView::modifierAiguillage(int n, int v)
     this->VoiesVariables[n]->setEtat(v);
 }
 
-void SimView::construireMaquette()
+void SimView::construireMaquette(bool geometrieRestauree)
 {
-    this->premiereVoie->calculerAnglesEtCoordonnees();
+    if(!geometrieRestauree)
+    {
+        this->premiereVoie->calculerAnglesEtCoordonnees();
+
+        this->premiereVoie->calculerPosition();
+    }
 
-    this->premiereVoie->calculerPosition();
+    simCore.chargerTopologie(this->Voies);
+    distancesAffichees.clear();
+    retournementsAffiches.clear();
 }
 
 void SimView::viderMaquette()
 {
+    // Les locos ne doivent plus désigner les voies détruites ci-dessous
+    foreach(Loco* l, this->Locos)
+    {
+        l->setVoie(nullptr);
+        l->setVoieSuivante(nullptr);
+    }
+
     foreach(Voie* v, this->Voies)
         delete v;
 
     this->Voies.clear();
+    this->segments.clear();
+    this->segmentsParContacts.clear();
+    this->tablesAnticipation.clear();
+    this->simCore.setTopologie(QMap<int, VoieSim>());
+    this->distancesAffichees.clear();
+    this->retournementsAffiches.clear();
 }
 
 void SimView::genererSegments()
 {
+    segmentsParContacts.clear();
+
     for(int i = 1; i <= this->contacts.size(); i++)
     {
         QList<QList<Voie*>*> parcours;
@@ -69,15 +109,13 @@ void SimView::genererSegments()
         {
             if(lv->last()->getContact() != nullptr)
             {
-                if(contacts.key(lv->first()->getContact()) < contacts.key(lv->last()->getContact()))
-                {
-                    segments.append(new Segment(lv->first()->getContact(), lv->last()->getContact(), *lv));
-                }
+                if(lv->first()->getContact()->getNumContact() < lv->last()->getContact()->getNumContact())
+                    ajouterSegment(new Segment(lv->first()->getContact(), lv->last()->getContact(), *lv));
             }
             else
             {
                 //gestion de segments entre un contact et une voie buttoir...
-                segments.append(new Segment(lv->first()->getContact(), nullptr, *lv));
+                ajouterSegment(new Segment(lv->first()->getContact(), nullptr, *lv));
             }
         }
 
@@ -95,7 +133,6 @@ void SimView::addLoco(Loco *l, int ID)
     this->Locos.insert(ID, l);
     this->scene->addItem(l);
 
-    CONNECT(l, SIGNAL(nouveauSegment(Contact*,Contact*,Loco*)), this, SLOT(locoSurNouveauSegment(Contact*,Contact*,Loco*)));
     CONNECT(this, SIGNAL(locoSurSegment(Segment*)), l, SLOT(locoSurSegment(Segment*)));
     CONNECT(this, SIGNAL(notificationVoieVariableModifiee(Voie*)), l, SLOT(voieVariableModifiee(Voie*)));
 
@@ -177,24 +214,50 @@ void SimView::zoomFit()
 
 Contact* SimView::getContact(int n)
 {
-    return this->contacts.value(n);
+    if(n < 0 || n >= contactsParNumero.size())
+        return nullptr;
+    return contactsParNumero.at(n);
 }
 
-Segment* SimView::getSegmentByContacts(int contactA, int contactB)
+int SimView::getNumContactMax() const
+{
+    return qMax(contactsParNumero.size() - 1, 0);
+}
+
+int SimView::getNumVoieVariableMax() const
+{
+    return VoiesVariables.isEmpty() ? 0 : VoiesVariables.lastKey();
+}
+
+void SimView::ajouterSegment(Segment *s)
+{
+    segments.append(s);
+
+    if(s->getContact2() != nullptr)
+        segmentsParContacts.insert(cleSegment(s->getContact1()->getNumContact(), s->getContact2()->getNumContact()), s);
+}
+
+const QList<Segment*>& SimView::getSegments() const
+{
+    return segments;
+}
+
+quint64 SimView::cleSegment(int contactA, int contactB)
 {
     int min = contactA < contactB ? contactA : contactB;
     int max = contactA < contactB ? contactB : contactA;
 
-    foreach(Segment* s, this->segments)
-    {
-        if(s->relie(this->contacts.value(min), this->contacts.value(max)))
-            return s;
-    }
-    return nullptr;
+    return (quint64(quint32(min)) << 32) | quint32(max);
+}
+
+Segment* SimView::getSegmentByContacts(int contactA, int contactB)
+{
+    return segmentsParContacts.value(cleSegment(contactA, contactB), nullptr);
 }
 
 void SimView::animationStart()
 {
+    chrono.start();
     timer->start(1000/FRAME_RATE);
 }
 
@@ -204,6 +267,10 @@ void SimView::animationStart()
 #include <QParallelAnimationGroup>
 #include <QThread>
 #include <QApplication>
+#include <QHash>
+#include <QVector>
+
+#include <cmath>
 
 #ifdef WITHSOUND
 #include <QSound>
@@ -229,105 +296,274 @@ protected:
 
 #endif // WITHSOUND
 
-void SimView::animationStep()
+namespace {
+
+/** Côté des cellules de la grille de collision. Quelle que soit son
+  * orientation, une loco couvre au plus 2x2 cellules.
+  */
+const qreal TAILLE_CELLULE_COLLISION = LONGUEUR_LOCO + LARGEUR_LOCO;
+
+int indiceCellule(qreal coordonnee)
 {
-    QList<Loco*> listeLocos = this->Locos.values();
+    return static_cast<int>(std::floor(coordonnee / TAILLE_CELLULE_COLLISION));
+}
 
-    bool tropProche;
+quint64 cleCellule(int x, int y)
+{
+    return (quint64(quint32(x)) << 32) | quint32(y);
+}
 
-    QList<Voie*> prochainesVoies;
+/** Test des axes séparateurs entre deux contours de loco, qui sont des
+  * rectangles orientés.
+  * \return vrai si aucun axe ne sépare les deux rectangles.
+  */
+bool rectanglesOrientesSeChevauchent(const QPolygonF &a, const QPolygonF &b)
+{
+    if(a.size() < 4 || b.size() < 4)
+        return true;
 
-    foreach(Loco* l, listeLocos)
+    const QPolygonF* contours[2] = {&a, &b};
+    for(const QPolygonF* contour : contours)
     {
-        if(l->getActive() && l->getVoie() != nullptr)
+        // Deux arêtes consécutives suffisent, les deux autres sont parallèles
+        for(int i = 0; i < 2; i++)
         {
-            if(l->getVitesse() != 0)
-                l->avancer((l->getVitesse() * 1000.0 / FRAME_RATE) * FACTEUR_VITESSE);
-
-            QPolygonF contourLoco = l->getContour();
-            QPolygonF contourAutreLoco;
-            //test de collision
-            foreach(Loco* otherLoco, listeLocos)
+            QPointF arete = contour->at(i + 1) - contour->at(i);
+            QPointF axe(-arete.y(), arete.x());
+            qreal minA = qInf(), maxA = -qInf(), minB = qInf(), maxB = -qInf();
+            for(int j = 0; j < 4; j++)
             {
-                if(l != otherLoco)
-                {
-                    contourAutreLoco = otherLoco->getContour();
-
-                    if(contourLoco.subtracted(contourAutreLoco) != contourLoco)
-                    {
-                        animationStop();
-                        l->setActive(false);
-                        otherLoco->setActive(false);
-                        ExplosionItem *item=new ExplosionItem();
-                        QPixmap img(":images/explosion.png");
-                        item->setPixmap(img);
-                        scene->addItem(item);
-                        QPointF debPoint((l->pos().x()+otherLoco->pos().x())/2,
-                                    (l->pos().y()+otherLoco->pos().y())/2);
-                        QPointF endPoint((l->pos().x()+otherLoco->pos().x())/2-256,
-                                    (l->pos().y()+otherLoco->pos().y())/2-256);
-                        item->setPos(endPoint);
-
-                        QPropertyAnimation *animation1=new QPropertyAnimation(item, "pos");
-                        animation1->setDuration(500);
-                        animation1->setStartValue(debPoint);
-                        animation1->setEndValue(endPoint);
-
-                        QPropertyAnimation *animation2=new QPropertyAnimation(item, "scale");
-                        animation2->setDuration(500);
-                        animation2->setStartValue(0.0);
-                        animation2->setEndValue(1.0);
-
-                        QParallelAnimationGroup *animationGroup=new QParallelAnimationGroup();
-
-                        animationGroup->addAnimation(animation1);
-                        animationGroup->addAnimation(animation2);
-
-                        item->setZValue(ZVAL_EXPLOSION);
-                        item->show();
-                        animationGroup->start();
+                qreal pa = QPointF::dotProduct(a.at(j), axe);
+                qreal pb = QPointF::dotProduct(b.at(j), axe);
+                minA = qMin(minA, pa); maxA = qMax(maxA, pa);
+                minB = qMin(minB, pb); maxB = qMax(maxB, pb);
+            }
+            if(maxA < minB || maxB < minA)
+                return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void SimView::exploser(Loco *l, Loco *otherLoco)
+{
+    animationStop();
+    l->setActive(false);
+    otherLoco->setActive(false);
+    simCore.setActive(Locos.key(l), false);
+    simCore.setActive(Locos.key(otherLoco), false);
+    ExplosionItem *item=new ExplosionItem();
+    QPixmap img(":images/explosion.png");
+    item->setPixmap(img);
+    scene->addItem(item);
+    QPointF debPoint((l->pos().x()+otherLoco->pos().x())/2,
+                (l->pos().y()+otherLoco->pos().y())/2);
+    QPointF endPoint((l->pos().x()+otherLoco->pos().x())/2-256,
+                (l->pos().y()+otherLoco->pos().y())/2-256);
+    item->setPos(endPoint);
+
+    QPropertyAnimation *animation1=new QPropertyAnimation(item, "pos");
+    animation1->setDuration(500);
+    animation1->setStartValue(debPoint);
+    animation1->setEndValue(endPoint);
+
+    QPropertyAnimation *animation2=new QPropertyAnimation(item, "scale");
+    animation2->setDuration(500);
+    animation2->setStartValue(0.0);
+    animation2->setEndValue(1.0);
+
+    QParallelAnimationGroup *animationGroup=new QParallelAnimationGroup();
+
+    animationGroup->addAnimation(animation1);
+    animationGroup->addAnimation(animation2);
+
+    item->setZValue(ZVAL_EXPLOSION);
+    item->show();
+    animationGroup->start();
 #ifdef WITHSOUND
-                        SoundThread *thread=new SoundThread(this);
-                        thread->start();
+    SoundThread *thread=new SoundThread(this);
+    thread->start();
 #endif // WITHSOUND
-                    }
-                }
-            }
+}
 
+void SimView::detecterCollisions(const QList<Loco*> &listeLocos)
+{
+    struct Candidat
+    {
+        Loco* loco;
+        QPolygonF contour;
+        QRectF englobant;
+    };
+    QVector<Candidat> candidats;
+    candidats.reserve(listeLocos.size());
 
-            //alerte proximite. Pas encore optimal.
-            qreal distanceSecurite = l->getVitesse() * 2000.0 * FACTEUR_VITESSE;
+    foreach(Loco* l, listeLocos)
+    {
+        if(l->getVoie() != nullptr)
+        {
+            QPolygonF contour = l->getContour();
+            candidats.append({l, contour, contour.boundingRect()});
+        }
+    }
 
-            prochainesVoies.append(l->getVoie());
-            prochainesVoies.append(l->getVoieSuivante());
-            distanceSecurite -= prochainesVoies.last()->getLongueurAParcourir();
+    // Chaque loco est inscrite dans les cellules couvertes par son rectangle englobant
+    QHash<quint64, QVector<int>> grille;
+    for(int i = 0; i < candidats.size(); i++)
+    {
+        const QRectF &r = candidats.at(i).englobant;
+        for(int x = indiceCellule(r.left()); x <= indiceCellule(r.right()); x++)
+            for(int y = indiceCellule(r.top()); y <= indiceCellule(r.bottom()); y++)
+                grille[cleCellule(x, y)].append(i);
+    }
 
-            while(distanceSecurite > 0)
+    // Seules les locos partageant une cellule sont comparées
+    for(auto it = grille.cbegin(); it != grille.cend(); ++it)
+    {
+        const QVector<int> &occupants = it.value();
+        for(int a = 0; a < occupants.size(); a++)
+        {
+            for(int b = a + 1; b < occupants.size(); b++)
             {
-                prochainesVoies.append(prochainesVoies.last()->getVoieSuivante(prochainesVoies.at(prochainesVoies.length()-2)));
-                distanceSecurite -= prochainesVoies.last()->getLongueurAParcourir();
+                const Candidat &ca = candidats.at(occupants.at(a));
+                const Candidat &cb = candidats.at(occupants.at(b));
+
+                if(!ca.loco->getActive() && !cb.loco->getActive())
+                    continue;
+                if(!ca.englobant.intersects(cb.englobant))
+                    continue;
+
+                // Une paire peut partager plusieurs cellules, seule celle
+                // contenant le coin de leur intersection la traite
+                QRectF intersection = ca.englobant.intersected(cb.englobant);
+                if(cleCellule(indiceCellule(intersection.left()), indiceCellule(intersection.top())) != it.key())
+                    continue;
+
+                if(!rectanglesOrientesSeChevauchent(ca.contour, cb.contour))
+                    continue;
+
+                if(ca.contour.subtracted(cb.contour) != ca.contour)
+                    exploser(ca.loco, cb.loco);
             }
+        }
+    }
+}
+
+void SimView::animationStep()
+{
+    QList<Loco*> listeLocos = this->Locos.values();
+
+    bool tropProche;
+
+    // Le coeur avance par pas fixes selon le temps réel écoulé. Une longue
+    // interruption (débogueur, fenêtre déplacée) n'est pas rattrapée.
+    simCore.avancer(qMin(chrono.restart() / 1000.0, 0.25));
+
+    InstantaneSim instantane = simCore.instantane();
+
+    for(auto it = Locos.cbegin(); it != Locos.cend(); ++it)
+    {
+        Loco* l = it.value();
+        if(!instantane.locos.contains(it.key()))
+            continue;
+
+        const LocoSim etat = instantane.locos.value(it.key());
+
+        // Vitesse et demi-tours suivent l'inertie calculée par le coeur. Une
+        // loco soumise à l'inertie est arrêtée lors de son demi-tour: la
+        // distance de ce pas est parcourue dans le nouveau sens.
+        l->setVitesse(etat.vitesse);
+        if(l->getVoie() != nullptr)
+        {
+            for(int n = retournementsAffiches.value(it.key()); n < etat.nbRetournements; n++)
+                l->inverserSens();
+        }
+        retournementsAffiches.insert(it.key(), etat.nbRetournements);
+
+        qreal parcouruTotal = etat.parcouruTotal;
+        qreal distance = parcouruTotal - distancesAffichees.value(it.key());
+        distancesAffichees.insert(it.key(), parcouruTotal);
+
+        if(l->getActive() && l->getVoie() != nullptr && distance > 0.0)
+            l->avancer(distance);
+    }
+
+    //test de collision
+    detecterCollisions(listeLocos);
+
+    foreach(Loco* l, listeLocos)
+    {
+        if(l->getActive() && l->getVoie() != nullptr)
+        {
+            //alerte proximite.
+            qreal distanceSecurite = l->getVitesse() * 2000.0 * FACTEUR_VITESSE;
+
+            const TableAnticipation &table = getTableAnticipation(l->getVoie(), l->getVoieSuivante(), distanceSecurite);
 
             tropProche = false;
 
-            foreach(Voie* v, prochainesVoies)
+            // La voie actuelle et la voie suivante sont toujours surveillées
+            for(int k = 0; k < table.voies.size() && (k < 2 || table.distances.at(k) < distanceSecurite); k++)
             {
-                foreach(Loco* autreLoco, listeLocos)
+                Voie* v = table.voies.at(k);
+                if(v->getNbLocos() > (v == l->getVoie() ? 1 : 0))
                 {
-                    if(autreLoco != l && v == autreLoco->getVoie())
-                    {
-                        tropProche = true;
-                    }
+                    tropProche = true;
+                    break;
                 }
             }
-            if(tropProche)
-                l->setAlerteProximite(true);
-            else
-                l->setAlerteProximite(false);
+            l->setAlerteProximite(tropProche);
+        }
+    }
+}
+
+const SimView::TableAnticipation& SimView::getTableAnticipation(Voie *voie, Voie *voieSuivante, qreal distance)
+{
+    TableAnticipation &table = tablesAnticipation[qMakePair(voie, voieSuivante)];
+
+    if(!table.voies.isEmpty() && table.portee >= distance)
+        return table;
 
-            prochainesVoies.clear();
+    // Une table couvre au moins la distance de sécurité à vitesse maximale
+    qreal portee = qMax(distance, VITESSE_MAXIMUM * 2000.0 * FACTEUR_VITESSE);
+
+    table.voies.clear();
+    table.distances.clear();
+    table.voies.append(voie);
+    table.distances.append(0.0);
+    // Parcours complet si une voie buttoir est atteinte
+    table.portee = qInf();
+
+    if(voieSuivante == nullptr)
+        return table;
+
+    table.voies.append(voieSuivante);
+    table.distances.append(0.0);
+
+    qreal parcouru = 0.0;
+    Voie* precedente = voie;
+    Voie* v = voieSuivante;
+    while(true)
+    {
+        parcouru += v->getLongueurAParcourir();
+        if(parcouru >= portee)
+        {
+            table.portee = portee;
+            break;
         }
+
+        Voie* suivante = v->getVoieSuivante(precedente);
+        if(suivante == nullptr)
+            break;
+
+        table.voies.append(suivante);
+        table.distances.append(parcouru);
+        precedente = v;
+        v = suivante;
     }
+
+    return table;
 }
 
 void SimView::animationStop()
@@ -341,7 +577,13 @@ void SimView::setLoco(int contactA, int contactB, int numLoco, int vitesseLoco)
 
     if (s == nullptr)
     {
-        QMessageBox::warning(this,"Error",QString("Les numéros de contact (%1,%2) entre lesquels se trouve la loco ne sont pas valides. Ils doivent être directement voisins.\nL'application va se terminer.").arg(contactA).arg(contactB));
+        QString message = QString("Les numéros de contact (%1,%2) entre lesquels se trouve la loco ne sont pas valides. Ils doivent être directement voisins.").arg(contactA).arg(contactB);
+        if (BatchRunner::estActif())
+        {
+            fprintf(stderr, "%s\n", qPrintable(message));
+            exit(BatchRunner::ERREUR);
+        }
+        QMessageBox::warning(this,"Error",message + "\nL'application va se terminer.");
         exit(-1);
     }
 
@@ -350,12 +592,17 @@ void SimView::setLoco(int contactA, int contactB, int numLoco, int vitesseLoco)
 
     Loco* l = this->Locos.value(numLoco);
 
-    this->Locos.value(numLoco)->setVitesse(vitesseLoco);
-
     l->setVoie(v);
 
     l->setVoieSuivante(contactA > contactB ? s->getSuivantMilieu() : s->getPrecedentMilieu());
 
+    simCore.placerLoco(numLoco, Voies.key(v, -1), Voies.key(l->getVoieSuivante(), -1));
+    simCore.setVitesse(numLoco, vitesseLoco, TrainSimSettings::getInstance()->getInertie());
+    const LocoSim etat = simCore.instantane().locos.value(numLoco);
+    distancesAffichees.insert(numLoco, etat.parcouruTotal);
+    retournementsAffiches.insert(numLoco, etat.nbRetournements);
+    l->setVitesse(etat.vitesse);
+
     l->setPos(v->pos());
 
     if(l->getVoieSuivante() == l->getVoie()->getVoieVoisineDOrdre(0))
@@ -379,28 +626,29 @@ void SimView::setVitesseLoco(int numLoco, int vitesseLoco)
 {
     if (!checkLoco(numLoco))
         return;
-    this->Locos.value(numLoco)->setVitesse(vitesseLoco);
+    simCore.setVitesse(numLoco, vitesseLoco, TrainSimSettings::getInstance()->getInertie());
 }
 
 void SimView::reverseLoco(int numLoco)
 {
     if (!checkLoco(numLoco))
         return;
-    this->Locos.value(numLoco)->inverserSens();
+    simCore.inverserSens(numLoco, TrainSimSettings::getInstance()->getInertie());
 }
 
 void SimView::setVitesseProgressiveLoco(int numLoco, int vitesseLoco)
 {
     if (!checkLoco(numLoco))
         return;
-    this->Locos.value(numLoco)->setVitesse(vitesseLoco); //similaire à setVitesseLoco!
+    //similaire à setVitesseLoco!
+    simCore.setVitesse(numLoco, vitesseLoco, TrainSimSettings::getInstance()->getInertie());
 }
 
 void SimView::stopLoco(int numLoco)
 {
     if (!checkLoco(numLoco))
         return;
-    this->Locos.value(numLoco)->setVitesse(0);
+    simCore.setVitesse(numLoco, 0, TrainSimSettings::getInstance()->getInertie());
 }
 
 void SimView::setVoieVariable(int numVoieVariable, int direction)
@@ -410,13 +658,41 @@ void SimView::setVoieVariable(int numVoieVariable, int direction)
     this->VoiesVariables.value(numVoieVariable)->setEtat(direction);
 }
 
-void SimView::locoSurNouveauSegment(Contact *ctc1, Contact *ctc2, Loco *l)
+void SimView::contactFranchi(int numLoco, int numContact)
 {
-    l->setSegmentActuel(getSegmentByContacts(contacts.key(ctc1), contacts.key(ctc2)));
+    Contact* c = getContact(numContact);
+    if (c == nullptr)
+        return;
+
+    Loco* l = Locos.value(numLoco);
+    if (l != nullptr)
+    {
+        // Le segment se termine au prochain contact sur la route de la loco
+        const LocoSim etat = simCore.getLocos().value(numLoco);
+        Voie* viensDe = Voies.value(etat.voie);
+        Voie* v = Voies.value(etat.voieSuivante);
+        Contact* suivant = nullptr;
+        for (int n = 0; v != nullptr && suivant == nullptr && n < Voies.size(); n++)
+        {
+            suivant = v->getContact();
+            Voie* apres = v->getVoieSuivante(viensDe);
+            viensDe = v;
+            v = apres;
+        }
+        Segment* s = nullptr;
+        if (suivant != nullptr)
+            s = getSegmentByContacts(numContact, suivant->getNumContact());
+        l->passeContact(numContact, s);
+    }
+
+    c->active(numLoco);
 }
 
 void SimView::voieVariableModifiee(Voie *v)
 {
+    // Le parcours des voies dépend de l'état des aiguillages
+    tablesAnticipation.clear();
+    simCore.actualiserVoie(v);
     notificationVoieVariableModifiee(v);
 }
 
@@ -425,7 +701,13 @@ bool SimView::checkLoco(int numLoco)
 {
     if (!this->Locos.contains(numLoco))
     {
-        QMessageBox::critical(this,"Erreur",QString("La loco %1 n'existe pas!\nL'application va se terminer.").arg(numLoco));
+        QString message = QString("La loco %1 n'existe pas!").arg(numLoco);
+        if (BatchRunner::estActif())
+        {
+            fprintf(stderr, "%s\n", qPrintable(message));
+            exit(BatchRunner::ERREUR);
+        }
+        QMessageBox::critical(this,"Erreur",message + "\nL'application va se terminer.");
         exit(-1);
     }
     return true;
@@ -435,7 +717,13 @@ bool SimView::checkVoieVariable(int numVoie)
 {
     if (!this->VoiesVariables.contains(numVoie))
     {
-        QMessageBox::critical(this,"Erreur",QString("La voie variable %1 n'existe pas sur la maquette sélectionnée!\nL'application va se terminer.").arg(numVoie));
+        QString message = QString("La voie variable %1 n'existe pas sur la maquette sélectionnée!").arg(numVoie);
+        if (BatchRunner::estActif())
+        {
+            fprintf(stderr, "%s\n", qPrintable(message));
+            exit(BatchRunner::ERREUR);
+        }
+        QMessageBox::critical(this,"Erreur",message + "\nL'application va se terminer.");
         exit(-1);
     }
     return true;
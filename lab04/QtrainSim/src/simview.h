@@ -3,6 +3,10 @@
 
 #include <QGraphicsView>
 #include <QGraphicsScene>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPair>
+#include <QVector>
 #include <QTimer>
 
 #include "connect.h"
@@ -10,6 +14,7 @@
 #include "voievariable.h"
 #include "loco.h"
 #include "segment.h"
+#include "simcore.h"
 
 
 class ExplosionItem :  public QObject, public QGraphicsPixmapItem
@@ -65,10 +70,13 @@ public:
     void modifierAiguillage(int n, int v);
 
     /** Lance la construction de la maquette (placement des voies, etc...)
+      * \param geometrieRestauree vrai si les voies ont déjà été posées avec une
+      *        géométrie lue dans le cache de la maquette, qui n'est alors pas recalculée.
       */
-    void construireMaquette();
+    void construireMaquette(bool geometrieRestauree = false);
 
     /** supprime toutes les voies, contacts, etc... en vue d'un nouveau chargement.
+      * Les locos sont détachées de leurs voies avant leur destruction.
       */
     void viderMaquette();
 
@@ -77,6 +85,16 @@ public:
       */
     void genererSegments();
 
+    /** Ajoute un segment déjà construit, lu dans le cache de la maquette.
+      * \param s le segment à ajouter.
+      */
+    void ajouterSegment(Segment* s);
+
+    /** retourne les segments de la maquette.
+      * \return les segments, dans l'ordre de leur création.
+      */
+    const QList<Segment*>& getSegments() const;
+
     /** Ajoute une locomotive.
       * \param l la loco à ajouter.
       * \param ID le numéro de la loco.
@@ -110,10 +128,25 @@ public:
       */
     Contact* getContact(int n);
 
+    /** retourne le plus grand numéro de contact de la maquette chargée.
+      * \return le numéro, 0 si la maquette n'a aucun contact.
+      */
+    int getNumContactMax() const;
+
+    /** retourne le plus grand numéro d'aiguillage de la maquette chargée.
+      * \return le numéro, 0 si la maquette n'a aucun aiguillage.
+      */
+    int getNumVoieVariableMax() const;
+
     /** raffraichit l'affichage.
       *
       */
     void redraw();
+
+    /** retourne le coeur de simulation, qui calcule le déplacement des locos.
+      * \return le coeur de simulation.
+      */
+    SimCore* getSimCore();
 signals:
 
     /** Signale qu'une loco a changé de segment, et se trouve que le segment s.
@@ -183,12 +216,6 @@ public slots:
       */
     void setVoieVariable(int numVoieVariable, int direction);
 
-    /** reçoit l'information qu'une loco a changé de segment.
-      * \param ctc1 et ctc2 définissent le segment.
-      * \param l la loco ayant changé de segment.
-      */
-    void locoSurNouveauSegment(Contact* ctc1, Contact* ctc2, Loco* l);
-
     /** reçoit l'information qu'une voie variable a été modifiée.
       * \param v la voie variable modifiée.
       */
@@ -205,12 +232,75 @@ private:
     QMap<int, Loco*> Locos;
     QList<Segment*> segments;
 
+    /** Contacts indexés par leur numéro, nullptr pour un numéro inutilisé. */
+    QVector<Contact*> contactsParNumero;
+    /** Segments indexés par la paire de numéros de leurs contacts, voir cleSegment. */
+    QHash<quint64, Segment*> segmentsParContacts;
+
+    /** retourne la clé d'un segment dans segmentsParContacts.
+      * \param contactA et contactB les numéros des contacts, dans un ordre quelconque.
+      * \return la clé du segment.
+      */
+    static quint64 cleSegment(int contactA, int contactB);
+
+    /** Coeur de simulation. La vue avance ses locos de la distance qu'il a calculée. */
+    SimCore simCore;
+    /** Temps réel écoulé depuis le dernier pas d'animation. */
+    QElapsedTimer chrono;
+    /** Distance totale de chaque loco déjà reportée sur son affichage. */
+    QMap<int, qreal> distancesAffichees;
+    /** Demi-tours de chaque loco déjà reportés sur son affichage. */
+    QMap<int, int> retournementsAffiches;
+
+    /** Voies rencontrées par une loco à partir de sa voie et de sa voie suivante.
+      * distances[k] est la distance parcourue depuis l'entrée dans la voie
+      * suivante jusqu'à l'entrée dans voies[k].
+      */
+    struct TableAnticipation
+    {
+        QVector<Voie*> voies;
+        QVector<qreal> distances;
+        qreal portee;
+    };
+
+    /** Tables d'anticipation par couple (voie, voie suivante), valables tant
+      * qu'aucune voie variable ne change d'état.
+      */
+    QHash<QPair<Voie*, Voie*>, TableAnticipation> tablesAnticipation;
+
+    /** retourne la table d'anticipation d'une loco, calculée au besoin.
+      * \param voie la voie de la loco.
+      * \param voieSuivante la voie vers laquelle la loco est dirigée.
+      * \param distance la distance que doit couvrir la table.
+      * \return la table d'anticipation.
+      */
+    const TableAnticipation& getTableAnticipation(Voie* voie, Voie* voieSuivante, qreal distance);
+
     /** retourne le segment correspondant à la paire de contacts passée en paramètre
       * \param contactA et contactB les contacts définissant les segment.
       * \return le segment correspondant.
       */
     Segment* getSegmentByContacts(int contactA, int contactB);
 
+    /** observateur de SimCore : active le contact franchi par une loco et
+      * met à jour le segment de la loco affichée.
+      * \param numLoco le numéro de la loco.
+      * \param numContact le numéro du contact franchi.
+      */
+    void contactFranchi(int numLoco, int numContact);
+
+    /** teste les collisions entre locos. Une grille uniforme limite les
+      * comparaisons aux locos voisines, et un test de rectangles orientés
+      * précède le test exact sur les contours.
+      * \param listeLocos les locos de la simulation.
+      */
+    void detecterCollisions(const QList<Loco*> &listeLocos);
+
+    /** arrête la simulation et affiche l'explosion de deux locos entrées en collision.
+      * \param l et otherLoco les locos accidentées.
+      */
+    void exploser(Loco* l, Loco* otherLoco);
+
     bool checkLoco(int numLoco);
 
     bool checkVoieVariable(int numVoie);
@@ -7,6 +7,7 @@
 Voie::Voie()
 {
     this->contact = nullptr;
+    this->nbLocos = 0;
     setZValue(ZVAL_VOIE);
 }
 
@@ -236,3 +237,65 @@ void Voie::mousePressEvent ( QGraphicsSceneMouseEvent * event )
     CommandeTrain::getInstance()->afficher_message(buf);
 }
 */
+
+void Voie::modifierOccupation(int delta)
+{
+    this->nbLocos += delta;
+}
+
+int Voie::getNbLocos()
+{
+    return this->nbLocos;
+}
+
+QVector<qreal> Voie::getGeometrie() const
+{
+    QVector<qreal> geometrie;
+
+    geometrie << pos().x() << pos().y() << coordonneesLiaison.size();
+    for(auto it = coordonneesLiaison.cbegin(); it != coordonneesLiaison.cend(); ++it)
+        geometrie << it.key() << angleLiaison.value(it.key()) << it.value()->x() << it.value()->y();
+
+    geometrie << getParametresGeometrie();
+
+    return geometrie;
+}
+
+bool Voie::restaurerGeometrie(const QVector<qreal> &geometrie)
+{
+    if(geometrie.size() < 3 || geometrie.at(2) != coordonneesLiaison.size() ||
+       geometrie.size() < 3 + 4 * coordonneesLiaison.size())
+        return false;
+
+    int indice = 3;
+    for(int i = 0; i < coordonneesLiaison.size(); i++, indice += 4)
+    {
+        int ordre = static_cast<int>(geometrie.at(indice));
+        if(!coordonneesLiaison.contains(ordre))
+            return false;
+        angleLiaison[ordre] = geometrie.at(indice + 1);
+        coordonneesLiaison[ordre]->setX(geometrie.at(indice + 2));
+        coordonneesLiaison[ordre]->setY(geometrie.at(indice + 3));
+    }
+
+    if(!setParametresGeometrie(geometrie.mid(indice)))
+        return false;
+
+    setPos(geometrie.at(0), geometrie.at(1));
+    orientee = posee = true;
+
+    if(this->contact != nullptr)
+        calculerPositionContact();
+
+    return true;
+}
+
+QVector<qreal> Voie::getParametresGeometrie() const
+{
+    return QVector<qreal>();
+}
+
+bool Voie::setParametresGeometrie(const QVector<qreal> &parametres)
+{
+    return parametres.isEmpty();
+}
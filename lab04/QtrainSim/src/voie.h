@@ -13,6 +13,7 @@
 #include <QPainter>
 #include <QStyleOptionGraphicsItem>
 #include <QMap>
+#include <QVector>
 
 #include "general.h"
 #include "contact.h"
@@ -214,7 +215,42 @@ public:
     void setIdVoie(int id);
 
     int getIdVoie();
+
+    /** indique qu'une loco arrive sur la voie ou la quitte.
+      * \param delta +1 à l'arrivée de la loco, -1 à son départ.
+      */
+    void modifierOccupation(int delta);
+
+    /** retourne le nombre de locos posées sur la voie.
+      * \return le nombre de locos posées sur la voie.
+      */
+    int getNbLocos();
+
+    /** retourne la géométrie résolue de la voie (position, angles et coordonnées
+      * de chaque extrémité, paramètres propres au type de voie), une fois posée.
+      * \return la géométrie, sous une forme pouvant être relue par restaurerGeometrie.
+      */
+    QVector<qreal> getGeometrie() const;
+
+    /** pose la voie avec une géométrie obtenue par getGeometrie, sans recalcul.
+      * Les liaisons et le contact doivent déjà être attribués.
+      * \param geometrie la géométrie à restaurer.
+      * \return faux si la géométrie ne correspond pas aux liaisons de la voie.
+      */
+    bool restaurerGeometrie(const QVector<qreal> &geometrie);
 protected:
+    /** retourne les paramètres géométriques propres au type de voie, ajustés
+      * lors de la pose (rayons et centres). Aucun par défaut.
+      * \return les paramètres.
+      */
+    virtual QVector<qreal> getParametresGeometrie() const;
+
+    /** restaure les paramètres retournés par getParametresGeometrie.
+      * \param parametres les paramètres.
+      * \return faux si leur nombre ne correspond pas au type de voie.
+      */
+    virtual bool setParametresGeometrie(const QVector<qreal> &parametres);
+
     QMap<int, Voie*> ordreLiaison;
     QMap<int, QPointF*> coordonneesLiaison;
     bool orientee, posee;
@@ -232,6 +268,7 @@ protected:
     //virtual void mousePressEvent ( QGraphicsSceneMouseEvent * event );
 private:
     QMap<int, qreal> angleLiaison;
+    int nbLocos;
 };
 
 #endif // VOIE_H
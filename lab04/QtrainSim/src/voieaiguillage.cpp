@@ -448,3 +448,19 @@ Voie* VoieAiguillage::getVoieSuivante(Voie *voieArrivee)
     }
     else return ordreLiaison.value(0);
 }
+
+QVector<qreal> VoieAiguillage::getParametresGeometrie() const
+{
+    return QVector<qreal>() << rayon << centre.x() << centre.y();
+}
+
+bool VoieAiguillage::setParametresGeometrie(const QVector<qreal> &parametres)
+{
+    if(parametres.size() != 3)
+        return false;
+
+    rayon = parametres.at(0);
+    centre = QPointF(parametres.at(1), parametres.at(2));
+
+    return true;
+}
@@ -563,3 +563,21 @@ Voie* VoieAiguillageEnroule::getVoieSuivante(Voie *voieArrivee)
     }
     else return ordreLiaison.value(0);
 }
+
+QVector<qreal> VoieAiguillageEnroule::getParametresGeometrie() const
+{
+    return QVector<qreal>() << rayonInterieur << rayonExterieur << centreInterieur.x() << centreInterieur.y() << centreExterieur.x() << centreExterieur.y();
+}
+
+bool VoieAiguillageEnroule::setParametresGeometrie(const QVector<qreal> &parametres)
+{
+    if(parametres.size() != 6)
+        return false;
+
+    rayonInterieur = parametres.at(0);
+    rayonExterieur = parametres.at(1);
+    centreInterieur = QPointF(parametres.at(2), parametres.at(3));
+    centreExterieur = QPointF(parametres.at(4), parametres.at(5));
+
+    return true;
+}
@@ -22,6 +22,11 @@ public:
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *) override;
 
     void mousePressEvent (QGraphicsSceneMouseEvent *) override;
+
+protected:
+    QVector<qreal> getParametresGeometrie() const override;
+    bool setParametresGeometrie(const QVector<qreal> &parametres) override;
+
 private:
     qreal rayonInterieur, rayonExterieur, angle, longueur, direction;
     QPointF centreInterieur;
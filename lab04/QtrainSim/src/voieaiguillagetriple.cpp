@@ -524,3 +524,21 @@ Voie* VoieAiguillageTriple::getVoieSuivante(Voie *voieArrivee)
     }
     else return ordreLiaison.value(0);
 }
+
+QVector<qreal> VoieAiguillageTriple::getParametresGeometrie() const
+{
+    return QVector<qreal>() << rayonGauche << rayonDroite << centreGauche.x() << centreGauche.y() << centreDroite.x() << centreDroite.y();
+}
+
+bool VoieAiguillageTriple::setParametresGeometrie(const QVector<qreal> &parametres)
+{
+    if(parametres.size() != 6)
+        return false;
+
+    rayonGauche = parametres.at(0);
+    rayonDroite = parametres.at(1);
+    centreGauche = QPointF(parametres.at(2), parametres.at(3));
+    centreDroite = QPointF(parametres.at(4), parametres.at(5));
+
+    return true;
+}
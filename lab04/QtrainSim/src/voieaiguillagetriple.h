@@ -21,6 +21,11 @@ public:
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *) override;
 
     void mousePressEvent (QGraphicsSceneMouseEvent *) override;
+
+protected:
+    QVector<qreal> getParametresGeometrie() const override;
+    bool setParametresGeometrie(const QVector<qreal> &parametres) override;
+
 private:
     qreal rayonGauche, rayonDroite, angle, longueur;
     QPointF centreGauche;
@@ -232,3 +232,19 @@ void VoieCourbe::setEtat(int /*nouvelEtat*/)
 {
     qDebug() << "Appel de setEtat sur une voie non variable.";
 }
+
+QVector<qreal> VoieCourbe::getParametresGeometrie() const
+{
+    return QVector<qreal>() << rayon << centre.x() << centre.y();
+}
+
+bool VoieCourbe::setParametresGeometrie(const QVector<qreal> &parametres)
+{
+    if(parametres.size() != 3)
+        return false;
+
+    rayon = parametres.at(0);
+    centre = QPointF(parametres.at(1), parametres.at(2));
+
+    return true;
+}
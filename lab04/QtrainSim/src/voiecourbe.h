@@ -22,6 +22,10 @@ public:
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *) override;
     void setEtat(int) override;
 
+protected:
+    QVector<qreal> getParametresGeometrie() const override;
+    bool setParametresGeometrie(const QVector<qreal> &parametres) override;
+
 private:
     QPointF centre;
     qreal rayon, angle;
@@ -418,3 +418,21 @@ void VoieTraverseeJonction::mousePressEvent ( QGraphicsSceneMouseEvent * /*event
     setEtat(1-this->etat);
     update();
 }
+
+QVector<qreal> VoieTraverseeJonction::getParametresGeometrie() const
+{
+    return QVector<qreal>() << rayon03 << rayon12 << centre03.x() << centre03.y() << centre12.x() << centre12.y();
+}
+
+bool VoieTraverseeJonction::setParametresGeometrie(const QVector<qreal> &parametres)
+{
+    if(parametres.size() != 6)
+        return false;
+
+    rayon03 = parametres.at(0);
+    rayon12 = parametres.at(1);
+    centre03 = QPointF(parametres.at(2), parametres.at(3));
+    centre12 = QPointF(parametres.at(4), parametres.at(5));
+
+    return true;
+}
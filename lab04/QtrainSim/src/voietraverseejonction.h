@@ -24,6 +24,11 @@ public:
     void setNumVoieVariable(int numVoieVariable) override;
 
     void mousePressEvent (QGraphicsSceneMouseEvent *) override;
+
+protected:
+    QVector<qreal> getParametresGeometrie() const override;
+    bool setParametresGeometrie(const QVector<qreal> &parametres) override;
+
 private:
     qreal rayon03, rayon12, angle, longueur;
     QPointF centre03;
@@ -3,6 +3,11 @@ include(../../QtrainSim/QtrainSim.pri)
 
 CONFIG += c++17
 
+# Signalisation par cantons au lieu de la section partagée: qmake CONFIG+=block_signalling
+block_signalling {
+    DEFINES += BLOCK_SIGNALLING=1
+}
+
 LIBS += -lpcosynchro
 
 HEADERS +=  \
@@ -11,10 +16,17 @@ HEADERS +=  \
     src/locomotive.h \
     src/launchable.h \
     src/locomotivebehavior.h \
-    src/sharedsection.h
+    src/sharedsection.h \
+    src/block.h \
+    src/blocksignalling.h \
+    src/reservationmanager.h \
+    src/blocklocomotivebehavior.h
 
 SOURCES +=  \
     src/locomotive.cpp \
     src/cppmain.cpp \
     src/locomotivebehavior.cpp \
-    src/route.cpp
+    src/route.cpp \
+    src/blocksignalling.cpp \
+    src/reservationmanager.cpp \
+    src/blocklocomotivebehavior.cpp
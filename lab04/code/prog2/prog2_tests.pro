@@ -0,0 +1,22 @@
+CONFIG += c++17
+CONFIG += console
+CONFIG -= app_bundle
+QT -= gui qt
+
+unix {
+    LIBS += -lpthread
+}
+
+LIBS += -lgtest
+LIBS += -lpcosynchro
+
+INCLUDEPATH += src test
+SOURCES += \
+    src/blocksignalling.cpp \
+    src/reservationmanager.cpp \
+    test/main.cpp
+
+HEADERS += \
+    src/block.h \
+    src/blocksignalling.h \
+    src/reservationmanager.h
@@ -0,0 +1,95 @@
+//    ___  _________    ___  ___  ___   __ //
+//   / _ \/ ___/ __ \  |_  |/ _ \|_  | / / //
+//  / ___/ /__/ /_/ / / __// // / __/ / /  //
+// /_/   \___/\____/ /____/\___/____//_/   //
+//                                         //
+// Auteurs: Valentin Kaelin & Lazar Pavicevic
+
+#ifndef BLOCK_H
+#define BLOCK_H
+
+#include <atomic>
+
+#include <pcosynchro/pcomutex.h>
+#include <pcosynchro/pcoconditionvariable.h>
+
+/**
+ * @brief La classe Block représente un canton de la maquette, réservé par au plus
+ * un train à la fois.
+ *
+ * La réservation tient dans un seul mot atomique, le numéro du train propriétaire:
+ * réserver et libérer un canton libre ne prennent aucun verrou. Le mutex et la
+ * condition du canton ne servent qu'aux trains qui doivent réellement attendre
+ * sa libération, et ne sont touchés par release que si un tel train existe.
+ */
+class Block
+{
+public:
+    /**
+     * @brief FREE Propriétaire d'un canton libre
+     */
+    static constexpr int FREE = -1;
+
+    Block() : owner(FREE), nbWaiting(0) {
+    }
+
+    Block(const Block&) = delete;
+    Block& operator=(const Block&) = delete;
+
+    /**
+     * @brief tryReserve Réserve le canton s'il est libre, sans attendre
+     * @param train Le numéro du train
+     * @return true si le canton est désormais réservé par le train
+     */
+    bool tryReserve(int train) {
+        int expected = FREE;
+        return owner.compare_exchange_strong(expected, train);
+    }
+
+    /**
+     * @brief release Libère le canton réservé par le train et réveille les trains
+     * qui attendent sa libération
+     * @param train Le numéro du train
+     */
+    void release(int train) {
+        int expected = train;
+        if (!owner.compare_exchange_strong(expected, FREE)) {
+            return;
+        }
+
+        // Un train qui s'annonce après cette lecture verra le canton libre
+        if (nbWaiting.load() > 0) {
+            mutex.lock();
+            freed.notifyAll();
+            mutex.unlock();
+        }
+    }
+
+    /**
+     * @brief waitFree Attend que le canton soit libre, sans le réserver
+     */
+    void waitFree() {
+        nbWaiting.fetch_add(1);
+        mutex.lock();
+        while (owner.load() != FREE) {
+            freed.wait(&mutex);
+        }
+        mutex.unlock();
+        nbWaiting.fetch_sub(1);
+    }
+
+    /**
+     * @brief getOwner Retourne le numéro du train qui a réservé le canton, FREE s'il est libre
+     */
+    int getOwner() const {
+        return owner.load();
+    }
+
+private:
+    std::atomic<int> owner;
+    std::atomic<int> nbWaiting;
+    PcoMutex mutex;
+    PcoConditionVariable freed;
+};
+
+#endif // BLOCK_H
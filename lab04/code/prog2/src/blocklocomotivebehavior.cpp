@@ -0,0 +1,96 @@
+//    ___  _________    ___  ___  ___   __ //
+//   / _ \/ ___/ __ \  |_  |/ _ \|_  | / / //
+//  / ___/ /__/ /_/ / / __// // / __/ / /  //
+// /_/   \___/\____/ /____/\___/____//_/   //
+//                                         //
+// Auteurs: Valentin Kaelin & Lazar Pavicevic
+
+#include <algorithm>
+
+#include "blocklocomotivebehavior.h"
+#include "locomotivebehavior.h"
+#include "ctrain_handler.h"
+
+using namespace std;
+
+void BlockLocomotiveBehavior::run() {
+    // Initialisation de la locomotive, placée juste après la fin du tour
+    loco.allumerPhares();
+    advance(-1);
+    loco.demarrer();
+    loco.afficherMessage("Ready!");
+
+    int nbTurns = NB_TURNS;
+
+    while(true) {
+        const vector<int>& contacts = route.getContacts();
+
+        for (int position = 0; position < static_cast<int>(contacts.size()); ++position) {
+            // Seul le passage de cette locomotive la fait avancer
+            attendre_contact_loco(contacts.at(position), loco.numero());
+            advance(position);
+
+            // Les cantons du tronçon partagé sont réservés: on peut l'aiguiller
+            if (contacts.at(position) == route.getSectionStart()) {
+                route.applyRailwaySwitches();
+            }
+        }
+
+        // Fin d'un tour
+        nbTurns--;
+        if (!nbTurns) {
+            inverse();
+            nbTurns = NB_TURNS;
+        }
+    }
+}
+
+void BlockLocomotiveBehavior::advance(int position) {
+    const vector<int>& contacts = route.getContacts();
+    int nbContacts = static_cast<int>(contacts.size());
+
+    // Contact franchi puis prochain tronçon, le parcours bouclant sur lui-même
+    vector<int> ahead = route.getLeg(position, BLOCK_LOOKAHEAD);
+    ahead.insert(ahead.begin(), contacts.at((position + nbContacts) % nbContacts));
+    vector<int> wanted = reservations->getSignalling().blocksOf(ahead);
+
+    // Les cantons quittés sont libérés avant d'attendre les suivants
+    for (int block : held) {
+        if (find(wanted.begin(), wanted.end(), block) == wanted.end()) {
+            reservations->release(loco.numero(), block);
+        }
+    }
+    held.clear();
+
+    if (!reservations->tryAcquire(loco.numero(), wanted)) {
+        loco.arreter();
+        loco.afficherMessage("En attente de cantons libres.");
+        // La locomotive se trouve dans le canton du contact franchi
+        ReservationManager::Duration waited = reservations->acquire(loco.numero(), wanted, {wanted.front()});
+        loco.demarrer();
+        loco.afficherMessage(QString("Cantons libérés après %1 ms, je repars.").arg(waited.count() / 1000));
+    }
+
+    held = wanted;
+}
+
+void BlockLocomotiveBehavior::printStartMessage() {
+    qDebug() << "[START] Thread de la loco" << loco.numero() << "lancé";
+    loco.afficherMessage("Je suis lancée !");
+}
+
+void BlockLocomotiveBehavior::printCompletionMessage() {
+    qDebug() << "[STOP] Thread de la loco" << loco.numero() << "a terminé correctement";
+    loco.afficherMessage("J'ai terminé");
+}
+
+void BlockLocomotiveBehavior::inverse() {
+    loco.arreter();
+    loco.inverserSens();
+    route.inverse();
+    // Les cantons devant la locomotive sont désormais ceux de l'autre sens
+    advance(-1);
+    loco.demarrer();
+    qDebug() << "[INVERSE] La loco" << loco.numero() << "a changé de sens";
+    loco.afficherMessage("J'ai changé de sens!");
+}
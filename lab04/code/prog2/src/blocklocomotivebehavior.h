@@ -0,0 +1,92 @@
+//    ___  _________    ___  ___  ___   __ //
+//   / _ \/ ___/ __ \  |_  |/ _ \|_  | / / //
+//  / ___/ /__/ /_/ / / __// // / __/ / /  //
+// /_/   \___/\____/ /____/\___/____//_/   //
+//                                         //
+// Auteurs: Valentin Kaelin & Lazar Pavicevic
+
+#ifndef BLOCKLOCOMOTIVEBEHAVIOR_H
+#define BLOCKLOCOMOTIVEBEHAVIOR_H
+
+#include <memory>
+#include <vector>
+
+#include "locomotive.h"
+#include "launchable.h"
+#include "reservationmanager.h"
+#include "route.h"
+
+// Nombre minimal de points de contact devant la locomotive dont elle réserve les cantons
+#define BLOCK_LOOKAHEAD 2
+
+/**
+ * @brief La classe BlockLocomotiveBehavior représente le comportement d'une locomotive
+ * circulant sur une maquette découpée en cantons.
+ *
+ * À chaque point de contact, la locomotive libère les cantons qu'elle a quittés puis
+ * réserve ceux du prochain tronçon de son parcours (Route::getLeg). Si l'un d'eux
+ * est réservé par un autre train, elle s'arrête jusqu'à obtenir tout le tronçon,
+ * en ne gardant que le canton où elle se trouve (voir ReservationManager::acquire).
+ */
+class BlockLocomotiveBehavior : public Launchable
+{
+public:
+    /*!
+     * \brief BlockLocomotiveBehavior Constructeur de la classe
+     * \param loco la locomotive dont on représente le comportement
+     * \param reservations le gestionnaire des cantons, partagé par toutes les locomotives
+     * \param route parcours de la locomotive
+     */
+    BlockLocomotiveBehavior(Locomotive& loco, std::shared_ptr<ReservationManager> reservations, Route& route)
+        : loco(loco), reservations(reservations), route(route) {
+    }
+
+protected:
+    /*!
+     * \brief run Fonction lancée par le thread, représente le comportement de la locomotive
+     */
+    void run() override;
+
+    /*!
+     * \brief printStartMessage Message affiché lors du démarrage du thread
+     */
+    void printStartMessage() override;
+
+    /*!
+     * \brief printCompletionMessage Message affiché lorsque le thread a terminé
+     */
+    void printCompletionMessage() override;
+
+    /*!
+     * \brief advance Ajuste les cantons réservés à la position de la locomotive
+     * \param position indice dans le parcours du dernier contact franchi, -1 avant le premier
+     */
+    void advance(int position);
+
+    /*!
+     * \brief inverse Arrête la locomotive, inverse son sens et la redémarre
+     */
+    void inverse();
+
+    /**
+     * @brief loco La locomotive dont on représente le comportement
+     */
+    Locomotive& loco;
+
+    /**
+     * @brief reservations Le gestionnaire des cantons de la maquette
+     */
+    std::shared_ptr<ReservationManager> reservations;
+
+    /**
+     * @brief route Parcours de la locomotive
+     */
+    Route& route;
+
+    /**
+     * @brief held Cantons actuellement réservés par la locomotive
+     */
+    std::vector<int> held;
+};
+
+#endif // BLOCKLOCOMOTIVEBEHAVIOR_H
@@ -0,0 +1,82 @@
+//    ___  _________    ___  ___  ___   __ //
+//   / _ \/ ___/ __ \  |_  |/ _ \|_  | / / //
+//  / ___/ /__/ /_/ / / __// // / __/ / /  //
+// /_/   \___/\____/ /____/\___/____//_/   //
+//                                         //
+// Auteurs: Valentin Kaelin & Lazar Pavicevic
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "blocksignalling.h"
+
+using namespace std;
+
+BlockSignalling::BlockSignalling(const vector<vector<int>>& blockContacts) {
+    for (size_t id = 0; id < blockContacts.size(); ++id) {
+        blocks.push_back(make_unique<Block>());
+
+        for (int contact : blockContacts.at(id)) {
+            if (contact < 0)
+                throw runtime_error("Numéro de point de contact invalide!");
+            if (static_cast<size_t>(contact) >= blockOfContact.size())
+                blockOfContact.resize(contact + 1, -1);
+            if (blockOfContact.at(contact) != -1)
+                throw runtime_error("Un point de contact ne peut appartenir qu'à un seul canton!");
+
+            blockOfContact.at(contact) = static_cast<int>(id);
+        }
+    }
+}
+
+int BlockSignalling::nbBlocks() const {
+    return static_cast<int>(blocks.size());
+}
+
+int BlockSignalling::blockOf(int contact) const {
+    if (contact < 0 || static_cast<size_t>(contact) >= blockOfContact.size())
+        return -1;
+    return blockOfContact.at(contact);
+}
+
+vector<int> BlockSignalling::blocksOf(const vector<int>& contacts) const {
+    vector<int> result;
+    for (int contact : contacts) {
+        int block = blockOf(contact);
+        if (block != -1 && find(result.begin(), result.end(), block) == result.end())
+            result.push_back(block);
+    }
+    return result;
+}
+
+bool BlockSignalling::tryReserve(int train, const vector<int>& wanted) {
+    vector<int> taken;
+
+    for (int block : wanted) {
+        Block& b = *blocks.at(block);
+        if (b.getOwner() == train)
+            continue;
+
+        if (!b.tryReserve(train)) {
+            // Tout ou rien: on rend ce qui vient d'être pris
+            for (int t : taken)
+                blocks.at(t)->release(train);
+            return false;
+        }
+        taken.push_back(block);
+    }
+
+    return true;
+}
+
+void BlockSignalling::waitFree(int block) {
+    blocks.at(block)->waitFree();
+}
+
+void BlockSignalling::release(int train, int block) {
+    blocks.at(block)->release(train);
+}
+
+int BlockSignalling::getOwner(int block) const {
+    return blocks.at(block)->getOwner();
+}
@@ -0,0 +1,93 @@
+//    ___  _________    ___  ___  ___   __ //
+//   / _ \/ ___/ __ \  |_  |/ _ \|_  | / / //
+//  / ___/ /__/ /_/ / / __// // / __/ / /  //
+// /_/   \___/\____/ /____/\___/____//_/   //
+//                                         //
+// Auteurs: Valentin Kaelin & Lazar Pavicevic
+
+#ifndef BLOCKSIGNALLING_H
+#define BLOCKSIGNALLING_H
+
+#include <memory>
+#include <vector>
+
+#include "block.h"
+
+/**
+ * @brief La classe BlockSignalling découpe la maquette en cantons et gère leur
+ * réservation par un nombre quelconque de trains.
+ *
+ * Chaque canton regroupe des points de contact consécutifs: un train est dans le
+ * canton du dernier contact qu'il a franchi. La réservation sans attente d'un
+ * ensemble de cantons est tout ou rien; l'attente et l'ordre des réservations
+ * sont laissés au ReservationManager.
+ *
+ * Il n'y a aucun verrou global: le découpage est fixé à la construction et
+ * chaque canton porte son propre état de réservation.
+ */
+class BlockSignalling
+{
+public:
+    /**
+     * @brief BlockSignalling Constructeur
+     * @param blocks Les points de contact de chaque canton, un contact n'appartenant
+     * qu'à un seul canton. L'identifiant d'un canton est son indice dans ce tableau.
+     */
+    explicit BlockSignalling(const std::vector<std::vector<int>>& blocks);
+
+    /**
+     * @brief nbBlocks Retourne le nombre de cantons
+     */
+    int nbBlocks() const;
+
+    /**
+     * @brief blockOf Retourne le canton d'un point de contact
+     * @param contact Le numéro du point de contact
+     * @return l'identifiant du canton, -1 si le contact n'appartient à aucun canton
+     */
+    int blockOf(int contact) const;
+
+    /**
+     * @brief blocksOf Retourne les cantons des points de contact donnés, sans doublons,
+     * dans l'ordre où ils sont rencontrés
+     * @param contacts Les numéros des points de contact
+     */
+    std::vector<int> blocksOf(const std::vector<int>& contacts) const;
+
+    /**
+     * @brief tryReserve Réserve tous les cantons donnés s'ils sont libres, sans attendre.
+     * Les cantons déjà réservés par le train sont acceptés tels quels.
+     * @param train Le numéro du train
+     * @param blocks Les cantons à réserver
+     * @return true si tous les cantons sont réservés par le train, false si aucun
+     * nouveau canton n'a été réservé
+     */
+    bool tryReserve(int train, const std::vector<int>& blocks);
+
+    /**
+     * @brief waitFree Attend qu'un canton soit libre, sans le réserver
+     * @param block Le canton
+     */
+    void waitFree(int block);
+
+    /**
+     * @brief release Libère un canton réservé par le train
+     * @param train Le numéro du train
+     * @param block Le canton à libérer
+     */
+    void release(int train, int block);
+
+    /**
+     * @brief getOwner Retourne le train qui a réservé un canton, Block::FREE s'il est libre
+     * @param block Le canton
+     */
+    int getOwner(int block) const;
+
+private:
+    std::vector<std::unique_ptr<Block>> blocks;
+
+    // Canton de chaque point de contact, indexé par le numéro du contact
+    std::vector<int> blockOfContact;
+};
+
+#endif // BLOCKSIGNALLING_H
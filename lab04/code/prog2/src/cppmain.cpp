@@ -5,6 +5,8 @@
 //                                         //
 // Auteurs: Valentin Kaelin & Lazar Pavicevic
 
+#include <algorithm>
+
 #include "ctrain_handler.h"
 
 #include "locomotive.h"
@@ -12,6 +14,15 @@
 #include "sharedsectioninterface.h"
 #include "sharedsection.h"
 #include "route.h"
+#include "blocksignalling.h"
+#include "reservationmanager.h"
+#include "blocklocomotivebehavior.h"
+
+// Signalisation par cantons (1) ou section partagée unique entre deux locomotives (0).
+// Activée par qmake CONFIG+=block_signalling
+#ifndef BLOCK_SIGNALLING
+#define BLOCK_SIGNALLING 0
+#endif
 
 using LocoId = SharedSectionInterface::LocoId;
 using RailwaySwitch = std::pair<int, int>;
@@ -22,6 +33,9 @@ static Locomotive locoA(7 /* Numéro (pour commande trains sur maquette réelle)
 // Locomotive B
 static Locomotive locoB(42 /* Numéro (pour commande trains sur maquette réelle) */, 10 /* Vitesse */);
 
+// Gestionnaire des cantons, en signalisation par cantons
+static std::shared_ptr<ReservationManager> reservations;
+
 // Arret d'urgence
 void emergency_stop()
 {
@@ -31,6 +45,16 @@ void emergency_stop()
     locoB.fixerVitesse(0);
 
     afficher_message("\nSTOP!");
+
+    // Temps d'attente des locos aux cantons
+    if (reservations) {
+        for (const Locomotive* loco : {&locoA, &locoB}) {
+            ReservationManager::WaitStats stats = reservations->getWaitStats(loco->numero());
+            afficher_message(qPrintable(QString("Loco %1: %2 attentes sur %3 tronçons, %4 ms au total, %5 ms au plus.")
+                                        .arg(loco->numero()).arg(stats.nbWaits).arg(stats.nbAcquisitions)
+                                        .arg(stats.total.count() / 1000).arg(stats.max.count() / 1000)));
+        }
+    }
 }
 
 
@@ -125,6 +149,29 @@ int cmain()
      * Threads des locos *
      ********************/
 
+#if BLOCK_SIGNALLING
+    // Découpage en cantons: un par point de contact des parcours. Le tronçon
+    // partagé compte plusieurs cantons, réservés ensemble par Route::getLeg
+    std::vector<int> points;
+    for (const std::vector<int>& route : {pointsA, pointsB}) {
+        for (int point : route) {
+            if (std::find(points.begin(), points.end(), point) == points.end()) {
+                points.push_back(point);
+            }
+        }
+    }
+    std::vector<std::vector<int>> blocks;
+    for (int point : points) {
+        blocks.push_back({point});
+    }
+    std::shared_ptr<BlockSignalling> signalling = std::make_shared<BlockSignalling>(blocks);
+    reservations = std::make_shared<ReservationManager>(signalling, std::vector<int>{locoA.numero(), locoB.numero()});
+
+    // Création du thread pour la loco A
+    std::unique_ptr<Launchable> locoBehaveA = std::make_unique<BlockLocomotiveBehavior>(locoA, reservations, routeA);
+    // Création du thread pour la loco B
+    std::unique_ptr<Launchable> locoBehaveB = std::make_unique<BlockLocomotiveBehavior>(locoB, reservations, routeB);
+#else
     // Création de la section partagée
     std::shared_ptr<SharedSectionInterface> sharedSection = std::make_shared<SharedSection>();
 
@@ -132,6 +179,7 @@ int cmain()
     std::unique_ptr<Launchable> locoBehaveA = std::make_unique<LocomotiveBehavior>(locoA, sharedSection, routeA, LocoId::LA);
     // Création du thread pour la loco B
     std::unique_ptr<Launchable> locoBehaveB = std::make_unique<LocomotiveBehavior>(locoB, sharedSection, routeB, LocoId::LB);
+#endif
 
     // Lancement des threads
     afficher_message(qPrintable(QString("Lancement thread loco A (numéro %1)").arg(locoA.numero())));
@@ -0,0 +1,129 @@
+//    ___  _________    ___  ___  ___   __ //
+//   / _ \/ ___/ __ \  |_  |/ _ \|_  | / / //
+//  / ___/ /__/ /_/ / / __// // / __/ / /  //
+// /_/   \___/\____/ /____/\___/____//_/   //
+//                                         //
+// Auteurs: Valentin Kaelin & Lazar Pavicevic
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "reservationmanager.h"
+
+using namespace std;
+using namespace std::chrono;
+
+ReservationManager::ReservationManager(shared_ptr<BlockSignalling> signalling, const vector<int>& trains)
+    : signalling(signalling) {
+    for (int train : trains) {
+        counters[train] = make_unique<Counters>();
+    }
+}
+
+BlockSignalling& ReservationManager::getSignalling() {
+    return *signalling;
+}
+
+bool ReservationManager::tryAcquire(int train, const vector<int>& blocks) {
+    bool acquired = signalling->tryReserve(train, blocks);
+    if (acquired) {
+        record(train, false, Duration::zero());
+    }
+    return acquired;
+}
+
+ReservationManager::Duration ReservationManager::acquire(int train, const vector<int>& blocks, const vector<int>& occupied) {
+    // Ordre global: les identifiants croissants
+    vector<int> ordered(blocks);
+    sort(ordered.begin(), ordered.end());
+    ordered.erase(unique(ordered.begin(), ordered.end()), ordered.end());
+
+    bool waited = false;
+    steady_clock::time_point start = steady_clock::now();
+
+    while (true) {
+        int missing = -1;
+        for (int block : ordered) {
+            if (!signalling->tryReserve(train, {block})) {
+                missing = block;
+                break;
+            }
+        }
+        if (missing == -1) {
+            break;
+        }
+
+        // Recul: seuls les cantons occupés restent réservés pendant l'attente
+        for (int block : ordered) {
+            if (find(occupied.begin(), occupied.end(), block) == occupied.end()) {
+                signalling->release(train, block);
+            }
+        }
+        waited = true;
+        waitFree(train, missing);
+    }
+
+    Duration duration = waited ? duration_cast<Duration>(steady_clock::now() - start) : Duration::zero();
+    record(train, waited, duration);
+    return duration;
+}
+
+void ReservationManager::waitFree(int train, int block) {
+    waitMutex.lock();
+    // Suit les attentes à partir du propriétaire du canton. Les trains en
+    // attente ne détiennent que des cantons occupés: un cycle ne se défera pas.
+    int owner = signalling->getOwner(block);
+    for (size_t n = 0; owner != Block::FREE && n <= waitingFor.size(); ++n) {
+        if (owner == train) {
+            waitMutex.unlock();
+            throw logic_error("Interblocage: le train " + to_string(train) + " attendrait le canton "
+                              + to_string(block) + " dans un cycle de trains face à face!");
+        }
+        auto it = waitingFor.find(owner);
+        if (it == waitingFor.end())
+            break;
+        owner = signalling->getOwner(it->second);
+    }
+    waitingFor[train] = block;
+    waitMutex.unlock();
+
+    signalling->waitFree(block);
+
+    waitMutex.lock();
+    waitingFor.erase(train);
+    waitMutex.unlock();
+}
+
+void ReservationManager::release(int train, int block) {
+    signalling->release(train, block);
+}
+
+ReservationManager::WaitStats ReservationManager::getWaitStats(int train) const {
+    auto it = counters.find(train);
+    if (it == counters.end())
+        throw runtime_error("Ce train n'est pas géré par le gestionnaire de réservations!");
+
+    const Counters& c = *it->second;
+    WaitStats stats;
+    stats.nbAcquisitions = c.nbAcquisitions.load();
+    stats.nbWaits = c.nbWaits.load();
+    stats.total = Duration(c.total.load());
+    stats.max = Duration(c.max.load());
+    return stats;
+}
+
+void ReservationManager::record(int train, bool waited, Duration duration) {
+    auto it = counters.find(train);
+    if (it == counters.end())
+        return;
+
+    Counters& c = *it->second;
+    c.nbAcquisitions.fetch_add(1);
+    if (waited) {
+        c.nbWaits.fetch_add(1);
+        c.total.fetch_add(duration.count());
+        // Seul le thread du train écrit ses statistiques
+        if (duration.count() > c.max.load())
+            c.max.store(duration.count());
+    }
+}
@@ -0,0 +1,127 @@
+//    ___  _________    ___  ___  ___   __ //
+//   / _ \/ ___/ __ \  |_  |/ _ \|_  | / / //
+//  / ___/ /__/ /_/ / / __// // / __/ / /  //
+// /_/   \___/\____/ /____/\___/____//_/   //
+//                                         //
+// Auteurs: Valentin Kaelin & Lazar Pavicevic
+
+#ifndef RESERVATIONMANAGER_H
+#define RESERVATIONMANAGER_H
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <pcosynchro/pcomutex.h>
+
+#include "blocksignalling.h"
+
+/**
+ * @brief La classe ReservationManager réserve les cantons d'un tronçon de parcours
+ * (le prochain "leg" d'une Route) sans interblocage, et mesure l'attente de chaque train.
+ *
+ * Les cantons d'un tronçon sont pris dans l'ordre croissant de leurs identifiants.
+ * Lorsque l'un d'eux est réservé par un autre train, le train recule: il rend
+ * tous les cantons du tronçon qu'il n'occupe pas physiquement, attend la
+ * libération du canton manquant puis recommence sa demande. Pendant une attente,
+ * un train ne détient donc que les cantons où il se trouve.
+ *
+ * Un cycle d'attente ne peut alors se former qu'entre trains qui attendent chacun
+ * un canton occupé par un autre, par exemple deux trains face à face sur une voie
+ * unique. Aucun recul ne peut le défaire: il est détecté avant l'attente et
+ * signalé par une exception. Les tronçons doivent l'exclure en s'étendant jusqu'à
+ * un canton où le train peut s'arrêter sans bloquer l'autre sens
+ * (voir Route::getLeg).
+ */
+class ReservationManager
+{
+public:
+    using Duration = std::chrono::microseconds;
+
+    /**
+     * @brief Les statistiques d'attente d'un train
+     */
+    struct WaitStats {
+        long nbAcquisitions = 0;
+        long nbWaits = 0;
+        Duration total = Duration::zero();
+        Duration max = Duration::zero();
+    };
+
+    /**
+     * @brief ReservationManager Constructeur
+     * @param signalling Les cantons de la maquette
+     * @param trains Les numéros des trains dont on mesure l'attente. Les statistiques
+     * sont allouées ici une fois pour toutes: leur mise à jour ne prend aucun verrou.
+     */
+    ReservationManager(std::shared_ptr<BlockSignalling> signalling, const std::vector<int>& trains);
+
+    /**
+     * @brief getSignalling Retourne les cantons de la maquette
+     */
+    BlockSignalling& getSignalling();
+
+    /**
+     * @brief tryAcquire Réserve tous les cantons donnés s'ils sont libres, sans attendre
+     * @param train Le numéro du train
+     * @param blocks Les cantons du tronçon
+     * @return true si tous les cantons sont réservés par le train
+     */
+    bool tryAcquire(int train, const std::vector<int>& blocks);
+
+    /**
+     * @brief acquire Réserve tous les cantons donnés dans l'ordre croissant de leurs
+     * identifiants, en attendant la libération de ceux réservés par d'autres trains.
+     * Avant chaque attente, les cantons du tronçon qui ne sont pas occupés sont
+     * rendus. Le train ne doit détenir aucun autre canton hors du tronçon.
+     * @param train Le numéro du train
+     * @param blocks Les cantons du tronçon
+     * @param occupied Les cantons où se trouve le train, déjà réservés et gardés
+     * pendant l'attente
+     * @return la durée de l'attente
+     * @throw std::logic_error si l'attente fermerait un cycle entre trains
+     */
+    Duration acquire(int train, const std::vector<int>& blocks, const std::vector<int>& occupied);
+
+    /**
+     * @brief release Libère un canton réservé par le train
+     * @param train Le numéro du train
+     * @param block Le canton
+     */
+    void release(int train, int block);
+
+    /**
+     * @brief getWaitStats Retourne les statistiques d'attente d'un train
+     * @param train Le numéro du train
+     */
+    WaitStats getWaitStats(int train) const;
+
+private:
+    // Statistiques d'un train, modifiées uniquement par son propre thread
+    struct Counters {
+        std::atomic<long> nbAcquisitions{0};
+        std::atomic<long> nbWaits{0};
+        std::atomic<long long> total{0};
+        std::atomic<long long> max{0};
+    };
+
+    void record(int train, bool waited, Duration duration);
+
+    /**
+     * @brief waitFree Attend la libération d'un canton, après avoir vérifié que
+     * son propriétaire n'attend pas, directement ou non, un canton du train
+     */
+    void waitFree(int train, int block);
+
+    std::shared_ptr<BlockSignalling> signalling;
+    std::map<int, std::unique_ptr<Counters>> counters;
+
+    // Canton attendu par chaque train en attente. Seules les attentes le
+    // consultent: la réservation sans conflit ne prend pas ce verrou.
+    PcoMutex waitMutex;
+    std::map<int, int> waitingFor;
+};
+
+#endif // RESERVATIONMANAGER_H
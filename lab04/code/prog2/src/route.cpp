@@ -15,7 +15,7 @@ using namespace std;
 
 Route::Route(const vector<int>& route, const vector<int>& shared,
              const vector<RailwaySwitch>& railwaySwitches)
-    : railwaySwitches(railwaySwitches), inversed(false)
+    : railwaySwitches(railwaySwitches), contacts(route), sharedContacts(shared), inversed(false)
 {
     if (!route.size() || !shared.size())
         throw runtime_error("Le parcours et la section partagée ne peuvent pas être vides!");
@@ -39,6 +39,11 @@ Route::Route(const vector<int>& route, const vector<int>& shared,
     contactRequestSharedInversed = *next(sectionEnd, 3);
     contactStartSharedInversed = *next(sectionEnd, 2);
     contactEndSharedInversed = *prev(sectionStart, 1);
+
+    // En sens inversé, la locomotive repart de la fin du tour: elle la
+    // rencontre à nouveau en dernier
+    contactsInversed.assign(route.rbegin() + 1, route.rend());
+    contactsInversed.push_back(contactEndTurn);
 }
 
 int Route::getSectionRequest() {
@@ -57,6 +62,27 @@ int Route::getTurnEnd() {
     return contactEndTurn;
 }
 
+const vector<int>& Route::getContacts() {
+    return inversed ? contactsInversed : contacts;
+}
+
+vector<int> Route::getLeg(int position, int minLength) {
+    const vector<int>& lap = getContacts();
+    int nbContacts = static_cast<int>(lap.size());
+    vector<int> leg;
+
+    for (int i = 1; i <= nbContacts; ++i) {
+        int contact = lap.at((position + i + nbContacts) % nbContacts);
+        leg.push_back(contact);
+
+        bool inShared = find(sharedContacts.begin(), sharedContacts.end(), contact) != sharedContacts.end();
+        if (i >= minLength && !inShared)
+            break;
+    }
+
+    return leg;
+}
+
 void Route::inverse() {
     inversed = !inversed;
 }
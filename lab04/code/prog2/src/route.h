@@ -54,6 +54,24 @@ public:
      */
     int getTurnEnd();
 
+    /**
+     * Retourne les points de contact d'un tour, dans l'ordre où la locomotive les
+     * rencontre dans son sens actuel. Le dernier est toujours la fin du tour.
+     * @return les numéros des points de contact
+     */
+    const std::vector<int>& getContacts();
+
+    /**
+     * Retourne les points de contact du prochain tronçon du parcours, dans le sens actuel.
+     * Le tronçon compte au moins minLength contacts et ne se termine jamais dans la
+     * section partagée: un train qui y entre en a réservé toute la traversée et ne
+     * peut s'y arrêter face à un train venant en sens inverse.
+     * @param position indice dans getContacts() du dernier contact franchi, -1 avant le premier
+     * @param minLength nombre minimal de contacts du tronçon
+     * @return les numéros des points de contact
+     */
+    std::vector<int> getLeg(int position, int minLength);
+
     /**
      * Informe que la locomotive a changé de sens
      */
@@ -80,6 +98,10 @@ private:
 
     int contactEndTurn;
 
+    std::vector<int> contacts, contactsInversed;
+
+    std::vector<int> sharedContacts;
+
     bool inversed;
 };
 
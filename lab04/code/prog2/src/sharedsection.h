@@ -9,7 +9,8 @@
 #define SHAREDSECTION_H
 
 #include <QDebug>
-#include <vector>
+#include <atomic>
+#include <cstdint>
 
 #include <pcosynchro/pcosemaphore.h>
 
@@ -20,6 +21,12 @@
 /**
  * @brief La classe SharedSection implémente l'interface SharedSectionInterface qui
  * propose les méthodes liées à la section partagée.
+ *
+ * Tout l'état de la section (occupation, requêtes, points d'entrée et nombre de
+ * locomotives en attente) tient dans un seul mot atomique modifié par
+ * compare-and-swap: request, getAccess et leave ne prennent aucun verrou. Seule
+ * une locomotive qui doit réellement attendre se bloque sur le sémaphore
+ * waiting. Les messages sont affichés hors de toute section critique.
  */
 class SharedSection final : public SharedSectionInterface
 {
@@ -29,8 +36,7 @@ public:
      * @brief SharedSection Constructeur de la classe qui représente la section partagée.
      * Initialisez vos éventuels attributs ici, sémaphores etc.
      */
-    SharedSection() : mutex(1), waiting(0), occupied(false),
-        nbWaiting(0), locoARequest(false), locoBRequest(false) {
+    SharedSection() : waiting(0), state(0) {
     }
 
     /**
@@ -41,16 +47,16 @@ public:
      * @param entryPoint Le point d'entree de la locomotive qui fait l'appel
      */
     void request(Locomotive& loco, LocoId locoId, EntryPoint entryPoint) override {
+        uint32_t current = state.load();
+        uint32_t next;
+        do {
+            next = (current | requestBit(locoId)) & ~entryBit(locoId);
+            if (entryPoint == EntryPoint::EB) {
+                next |= entryBit(locoId);
+            }
+        } while (!state.compare_exchange_weak(current, next));
+
         afficher_message(qPrintable(QString("The engine no. %1 requested the shared section.").arg(loco.numero())));
-        mutex.acquire();
-        if (locoId == LocoId::LA) {
-            locoARequest = true;
-            locoAEntry = entryPoint;
-        } else if (locoId == LocoId::LB) {
-            locoBRequest = true;
-            locoBEntry = entryPoint;
-        }
-        mutex.release();
     }
 
 
@@ -64,28 +70,26 @@ public:
      * @param locoId L'identidiant de la locomotive qui fait l'appel
      */
     void getAccess(Locomotive &loco, LocoId locoId) override {
-        mutex.acquire();
-        if (!canAccess(locoId)) {
-            nbWaiting++;
+        uint32_t current = state.load();
+        uint32_t next;
+        bool access;
+        do {
+            access = canAccess(current, locoId);
+            // Accès: la section est occupée et la requête terminée.
+            // Sinon, la locomotive s'annonce comme en attente.
+            next = access ? (current | OCCUPIED) & ~requestBit(locoId) : current + ONE_WAITING;
+        } while (!state.compare_exchange_weak(current, next));
+
+        if (!access) {
             loco.arreter();
-            mutex.release();
             afficher_message(qPrintable(QString("The engine no. %1 is waiting for the shared section.").arg(loco.numero())));
+            // leave transmet la section occupée directement à la locomotive réveillée
             waiting.acquire();
-            mutex.acquire();
+            state.fetch_and(~requestBit(locoId));
             loco.demarrer();
-        } else {
-            occupied = true;
-        }
-
-        // La requête d'accès est terminée car la loco a maintenant accès
-        if (locoId == LocoId::LA) {
-            locoARequest = false;
-        } else if (locoId == LocoId::LB) {
-            locoBRequest = false;
         }
 
         afficher_message(qPrintable(QString("The engine no. %1 accesses the shared section.").arg(loco.numero())));
-        mutex.release();
     }
 
     /**
@@ -94,36 +98,59 @@ public:
      * @param loco La locomotive qui quitte la section partagée
      * @param locoId L'identidiant de la locomotive qui fait l'appel
      */
-    void leave(Locomotive& loco, LocoId locoId) override {
-        afficher_message(qPrintable(QString("The engine no. %1 leaves the shared section.").arg(loco.numero())));
-        mutex.acquire();
-
-        if (nbWaiting == 0) {
-            occupied = false;
-        } else {
-            nbWaiting--;
+    void leave(Locomotive& loco, LocoId /* locoId */) override {
+        uint32_t current = state.load();
+        uint32_t next;
+        do {
+            // Sans attente la section est libérée, sinon elle reste occupée
+            // et passe à une locomotive en attente
+            next = nbWaiting(current) == 0 ? current & ~OCCUPIED : current - ONE_WAITING;
+        } while (!state.compare_exchange_weak(current, next));
+
+        if (nbWaiting(current) > 0) {
             waiting.release();
         }
-        mutex.release();
+
+        afficher_message(qPrintable(QString("The engine no. %1 leaves the shared section.").arg(loco.numero())));
     }
 
 private:
-    PcoSemaphore mutex, waiting;
-    bool occupied;
-    int nbWaiting;
+    // Disposition du mot d'état
+    static constexpr uint32_t OCCUPIED = 1u << 0;
+    static constexpr uint32_t REQUEST_A = 1u << 1;
+    static constexpr uint32_t REQUEST_B = 1u << 2;
+    // Bit levé si le point d'entrée est EB
+    static constexpr uint32_t ENTRY_A = 1u << 3;
+    static constexpr uint32_t ENTRY_B = 1u << 4;
+    // Nombre de locomotives en attente, dans les bits de poids fort
+    static constexpr int WAITING_SHIFT = 8;
+    static constexpr uint32_t ONE_WAITING = 1u << WAITING_SHIFT;
+
+    PcoSemaphore waiting;
+    std::atomic<uint32_t> state;
+
+    static uint32_t requestBit(LocoId locoId) {
+        return locoId == LocoId::LA ? REQUEST_A : REQUEST_B;
+    }
 
-    EntryPoint locoAEntry, locoBEntry;
-    bool locoARequest, locoBRequest;
+    static uint32_t entryBit(LocoId locoId) {
+        return locoId == LocoId::LA ? ENTRY_A : ENTRY_B;
+    }
+
+    static uint32_t nbWaiting(uint32_t s) {
+        return s >> WAITING_SHIFT;
+    }
 
-    bool canAccess(LocoId locoId) {
-        if (occupied) return false;
+    static bool canAccess(uint32_t s, LocoId locoId) {
+        if (s & OCCUPIED) return false;
 
         // Si une seule loco a fait une requête: elle a l'accès
-        if (!locoARequest || !locoBRequest) return true;
+        if (!(s & REQUEST_A) || !(s & REQUEST_B)) return true;
 
         // Si les deux locos ont fait une requête, on regarde les points d'entrée
         // afin d'appliquer les règles de priorité
-        return locoId == LocoId::LA ? locoAEntry == locoBEntry : locoAEntry != locoBEntry;
+        bool sameEntry = !(s & ENTRY_A) == !(s & ENTRY_B);
+        return locoId == LocoId::LA ? sameEntry : !sameEntry;
     }
 };
 
@@ -0,0 +1,102 @@
+//    ___  _________    ___  ___  ___   __ //
+//   / _ \/ ___/ __ \  |_  |/ _ \|_  | / / //
+//  / ___/ /__/ /_/ / / __// // / __/ / /  //
+// /_/   \___/\____/ /____/\___/____//_/   //
+//                                         //
+// Auteurs: Valentin Kaelin & Lazar Pavicevic
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <pcosynchro/pcotest.h>
+
+#include "reservationmanager.h"
+
+using namespace std;
+
+namespace {
+
+// Voie unique avec un évitement: 0 -1- [3|4] -2- 5. Les tronçons vont d'une
+// extrémité à une voie de l'évitement, ou inversement.
+const vector<vector<int>> LEGS = {
+    {0, 1, 3},
+    {3, 2, 5},
+    {5, 2, 4},
+    {4, 1, 0},
+};
+
+shared_ptr<ReservationManager> makeManager(const vector<int>& trains) {
+    // Un contact par canton, de même numéro
+    vector<vector<int>> blocks;
+    for (int id = 0; id < 6; ++id)
+        blocks.push_back({id});
+    return make_shared<ReservationManager>(make_shared<BlockSignalling>(blocks), trains);
+}
+
+// Parcourt les tronçons à partir du premier, en libérant tous les cantons
+// sauf celui d'arrivée une fois le tronçon obtenu
+void drive(ReservationManager& manager, int train, size_t first, int nbLegs) {
+    for (int n = 0; n < nbLegs; ++n) {
+        const vector<int>& leg = LEGS.at((first + n) % LEGS.size());
+        manager.acquire(train, leg, {leg.front()});
+        for (size_t i = 0; i + 1 < leg.size(); ++i)
+            manager.release(train, leg.at(i));
+    }
+}
+
+} // namespace
+
+// Deux trains parcourent les mêmes cantons en sens opposés. Un train arrêté
+// dans le canton 5 attend le canton 2 pendant que l'autre, qui a déjà pris le
+// canton 2, attend le canton 5: sans recul, ils s'interbloquent.
+TEST(ReservationManager, OppositeLegs) {
+    ASSERT_DURATION_LE(30, ({
+        auto manager = makeManager({1, 2});
+        ASSERT_TRUE(manager->tryAcquire(1, {0}));
+        ASSERT_TRUE(manager->tryAcquire(2, {5}));
+
+        thread t1(drive, ref(*manager), 1, 0, 20000);
+        thread t2(drive, ref(*manager), 2, 2, 20000);
+        t1.join();
+        t2.join();
+
+        EXPECT_EQ(manager->getSignalling().getOwner(0), 1);
+        EXPECT_EQ(manager->getSignalling().getOwner(5), 2);
+    }))
+}
+
+// Deux trains face à face: aucun recul ne peut les départager, l'un des deux
+// doit le signaler au lieu d'attendre
+TEST(ReservationManager, HeadOnIsReported) {
+    ASSERT_DURATION_LE(30, ({
+        auto manager = makeManager({1, 2});
+        ASSERT_TRUE(manager->tryAcquire(1, {0}));
+        ASSERT_TRUE(manager->tryAcquire(2, {1}));
+
+        atomic<int> nbReported{0};
+        auto headOn = [&manager, &nbReported](int train, vector<int> leg) {
+            try {
+                manager->acquire(train, leg, {leg.front()});
+            } catch (const logic_error&) {
+                nbReported++;
+                // Le train signalé cède sa place: l'autre obtient son tronçon
+                manager->release(train, leg.front());
+            }
+        };
+        thread t1(headOn, 1, vector<int>{0, 1});
+        thread t2(headOn, 2, vector<int>{1, 0});
+        t1.join();
+        t2.join();
+
+        EXPECT_EQ(nbReported.load(), 1);
+    }))
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,174 @@
+/*
+Auteurs: Alexandre Jaquier, Valentin Kaelin
+Date: 19.10.2026
+Description: Benchmarks des multiplicateurs de matrices (Google Benchmark).
+             Balaye la taille des matrices, le type des éléments, le nombre
+             de threads et le nombre de blocs par ligne, pour chaque paire
+             (type de stockage, type d'accumulation). Chaque mesure est
+             répétée et le débit est reporté en GFLOPS.
+
+Utilisation:
+    ./labo6_bench --benchmark_out=resultats.json --benchmark_out_format=json
+Deux fichiers JSON peuvent ensuite être comparés avec l'outil compare.py
+fourni par Google Benchmark.
+*/
+
+#include <cstdlib>
+
+#include <benchmark/benchmark.h>
+
+#include "matrix.h"
+#include "simplematrixmultiplier.h"
+#include "threadedmatrixmultiplier.h"
+
+// Nombre de répétitions de chaque mesure, afin d'obtenir moyenne, médiane et écart-type
+constexpr int NBREPETITIONS = 5;
+// Valeurs générées volontairement petites pour éviter tout dépassement
+constexpr int MAX_VALUE = 100;
+
+/**
+ * Remplit une matrice de valeurs aléatoires bornées
+ */
+template<class T>
+void fillMatrix(SquareMatrix<T>& matrix)
+{
+    for (int i = 0; i < matrix.size(); i++)
+        for (int j = 0; j < matrix.size(); j++)
+            matrix.setElement(i, j, static_cast<T>(rand() % MAX_VALUE));
+}
+
+/**
+ * Remet à zéro la matrice résultat, les multiplicateurs accumulant dans C
+ */
+template<class T>
+void clearMatrix(SquareMatrix<T>& matrix)
+{
+    for (int i = 0; i < matrix.size(); i++)
+        for (int j = 0; j < matrix.size(); j++)
+            matrix.setElement(i, j, T{});
+}
+
+/**
+ * Ajoute le compteur de GFLOPS (une multiplication et une addition par
+ * élément du produit scalaire, donc 2 * n^3 opérations par multiplication)
+ */
+void setFlopsCounter(benchmark::State& state, int matrixSize)
+{
+    double flops = 2.0 * matrixSize * matrixSize * matrixSize;
+    state.counters["GFLOPS"] = benchmark::Counter(flops * 1e-9, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+/**
+ * Multiplication séquentielle de référence
+ * Argument: taille de la matrice
+ */
+template<class Traits>
+void BM_SimpleMultiplier(benchmark::State& state)
+{
+    using T = typename Traits::StorageType;
+    using Accumulator = typename Traits::AccumulatorType;
+
+    const int matrixSize = state.range(0);
+
+    SquareMatrix<T> A(matrixSize);
+    SquareMatrix<T> B(matrixSize);
+    SquareMatrix<Accumulator> C(matrixSize);
+    fillMatrix(A);
+    fillMatrix(B);
+
+    SimpleMatrixMultiplier<T, Traits> multiplier;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        clearMatrix(C);
+        state.ResumeTiming();
+
+        multiplier.multiply(A, B, &C);
+        benchmark::ClobberMemory();
+    }
+
+    setFlopsCounter(state, matrixSize);
+}
+
+/**
+ * Multiplication multi-thread
+ * Arguments: taille de la matrice, nombre de threads, nombre de blocs par ligne
+ */
+template<class Traits>
+void BM_ThreadedMultiplier(benchmark::State& state)
+{
+    using T = typename Traits::StorageType;
+    using Accumulator = typename Traits::AccumulatorType;
+
+    const int matrixSize = state.range(0);
+    const int nbThreads = state.range(1);
+    const int nbBlocksPerRow = state.range(2);
+
+    SquareMatrix<T> A(matrixSize);
+    SquareMatrix<T> B(matrixSize);
+    SquareMatrix<Accumulator> C(matrixSize);
+    fillMatrix(A);
+    fillMatrix(B);
+
+    // Le groupe de threads partagé est redimensionné pour chaque mesure,
+    // sa création n'est pas mesurée
+    WorkerPool::configureShared(nbThreads);
+    ThreadedMatrixMultiplier<T, Traits> multiplier(nbThreads, nbBlocksPerRow);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        clearMatrix(C);
+        state.ResumeTiming();
+
+        multiplier.multiply(A, B, &C);
+        benchmark::ClobberMemory();
+    }
+
+    setFlopsCounter(state, matrixSize);
+}
+
+/**
+ * Génère les combinaisons (taille, threads, blocs) mesurées.
+ * Le nombre de blocs par ligne doit diviser la taille de la matrice.
+ */
+void threadedArguments(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({"size", "threads", "blocks"});
+    for (int matrixSize : {128, 256, 512})
+        for (int nbThreads : {1, 2, 4, 8})
+            for (int nbBlocksPerRow : {1, 2, 4, 8})
+                benchmark->Args({matrixSize, nbThreads, nbBlocksPerRow});
+}
+
+void simpleArguments(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({"size"});
+    for (int matrixSize : {128, 256, 512})
+        benchmark->Args({matrixSize});
+}
+
+// Le temps réel est mesuré: le calcul a lieu dans les threads de travail,
+// le temps CPU du thread principal n'aurait aucun sens.
+#define REGISTER_MULTIPLIER_BENCHMARK(function, traits, arguments) \
+    BENCHMARK_TEMPLATE(function, traits) \
+        ->Apply(arguments) \
+        ->Unit(benchmark::kMillisecond) \
+        ->UseRealTime() \
+        ->Repetitions(NBREPETITIONS) \
+        ->DisplayAggregatesOnly(true)
+
+REGISTER_MULTIPLIER_BENCHMARK(BM_SimpleMultiplier, SameAccumulation<int>, simpleArguments);
+REGISTER_MULTIPLIER_BENCHMARK(BM_SimpleMultiplier, SameAccumulation<float>, simpleArguments);
+REGISTER_MULTIPLIER_BENCHMARK(BM_SimpleMultiplier, SameAccumulation<double>, simpleArguments);
+REGISTER_MULTIPLIER_BENCHMARK(BM_SimpleMultiplier, WideAccumulation<int8_t>, simpleArguments);
+REGISTER_MULTIPLIER_BENCHMARK(BM_SimpleMultiplier, WideAccumulation<int32_t>, simpleArguments);
+REGISTER_MULTIPLIER_BENCHMARK(BM_SimpleMultiplier, WideAccumulation<float>, simpleArguments);
+
+REGISTER_MULTIPLIER_BENCHMARK(BM_ThreadedMultiplier, SameAccumulation<int>, threadedArguments);
+REGISTER_MULTIPLIER_BENCHMARK(BM_ThreadedMultiplier, SameAccumulation<float>, threadedArguments);
+REGISTER_MULTIPLIER_BENCHMARK(BM_ThreadedMultiplier, SameAccumulation<double>, threadedArguments);
+REGISTER_MULTIPLIER_BENCHMARK(BM_ThreadedMultiplier, WideAccumulation<int8_t>, threadedArguments);
+REGISTER_MULTIPLIER_BENCHMARK(BM_ThreadedMultiplier, WideAccumulation<int32_t>, threadedArguments);
+REGISTER_MULTIPLIER_BENCHMARK(BM_ThreadedMultiplier, WideAccumulation<float>, threadedArguments);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,30 @@
+
+CONFIG += c++17
+CONFIG += console
+CONFIG -= app_bundle
+QT -= gui qt
+
+unix {
+    LIBS += -lpthread
+}
+
+# Instrumentation du groupe de threads: qmake CONFIG+=config_profiling
+config_profiling {
+    DEFINES += WORKERPOOL_PROFILING
+}
+
+LIBS += -lbenchmark
+LIBS += -lpcosynchro
+
+INCLUDEPATH += src bench
+SOURCES += \
+    bench/main.cpp
+
+HEADERS += \
+    src/abstractmatrixmultiplier.h \
+    src/accumulationtraits.h \
+    src/jobprofiler.h \
+    src/matrix.h \
+    src/simplematrixmultiplier.h \
+    src/threadedmatrixmultiplier.h \
+    src/workerpool.h
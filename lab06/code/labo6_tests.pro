@@ -8,6 +8,11 @@ unix {
     LIBS += -lpthread
 }
 
+# Instrumentation du groupe de threads: qmake CONFIG+=config_profiling
+config_profiling {
+    DEFINES += WORKERPOOL_PROFILING
+}
+
 LIBS += -lgtest
 LIBS += -lpcosynchro
 
@@ -17,11 +22,19 @@ SOURCES += \
 
 HEADERS += \
     src/abstractmatrixmultiplier.h \
+    src/abstractsparsematrixmultiplier.h \
+    src/accumulationtraits.h \
+    src/jobprofiler.h \
     src/matrix.h \
     src/simplematrixmultiplier.h \
+    src/simplesparsematrixmultiplier.h \
+    src/sparsematrix.h \
     src/threadedmatrixmultiplier.h \
+    src/threadedsparsematrixmultiplier.h \
+    src/workerpool.h \
     test/multipliertester.h \
-    test/multiplierthreadedtester.h
+    test/multiplierthreadedtester.h \
+    test/sparsemultipliertester.h
 
 DISTFILES += \
     ../sources.pri \
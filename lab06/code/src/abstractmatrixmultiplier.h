@@ -1,20 +1,31 @@
 #ifndef ABSTRACTMATRIXMULTIPLIER_H
 #define ABSTRACTMATRIXMULTIPLIER_H
 
+#include <type_traits>
+
+#include "accumulationtraits.h"
 #include "matrix.h"
 
 /**
  * The abstract matrix multiplier, only supplying a method for the
  * multiplication.
+ * Traits selects the type in which the products are accumulated, and hence
+ * the element type of the result matrix.
  */
-template<class T>
+template<class T, class Traits = SameAccumulation<T>>
 class AbstractMatrixMultiplier
 {
+    static_assert(std::is_same<T, typename Traits::StorageType>::value,
+                  "The accumulation traits do not match the element type");
+
 public:
+    using AccumulationTraits = Traits;
+    using Accumulator = typename Traits::AccumulatorType;
+
     /**
      * C = A * B
      */
-    virtual void multiply(SquareMatrix<T>& A, SquareMatrix<T>& B, SquareMatrix<T>* C) = 0;
+    virtual void multiply(SquareMatrix<T>& A, SquareMatrix<T>& B, SquareMatrix<Accumulator>* C) = 0;
 
     //! Empty virtual destructor, needed for correct polymorphism
     virtual ~AbstractMatrixMultiplier() {}
@@ -23,6 +34,11 @@ public:
     {
         return T{};
     }
+
+    static auto getAccumulatorType()
+    {
+        return Accumulator{};
+    }
 };
 
 #endif // ABSTRACTMATRIXMULTIPLIER_H
@@ -0,0 +1,161 @@
+#ifndef ABSTRACTSPARSEMATRIXMULTIPLIER_H
+#define ABSTRACTSPARSEMATRIXMULTIPLIER_H
+
+/*
+Auteurs: Alexandre Jaquier, Valentin Kaelin
+Date: 19.10.2026
+Description: Interface des multiplicateurs de matrices creuses et noyaux
+             de calcul par plage de lignes
+*/
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include "accumulationtraits.h"
+#include "matrix.h"
+#include "sparsematrix.h"
+
+/**
+ * The abstract sparse matrix multiplier. A is always sparse, B and C are
+ * either dense (SpMM) or sparse (SpGEMM).
+ */
+template<class T, class Traits = SameAccumulation<T>>
+class AbstractSparseMatrixMultiplier
+{
+    static_assert(std::is_same<T, typename Traits::StorageType>::value,
+                  "The accumulation traits do not match the element type");
+
+public:
+    using AccumulationTraits = Traits;
+    using Accumulator = typename Traits::AccumulatorType;
+
+    /**
+     * C += A * B, with a sparse A and dense B and C
+     */
+    virtual void multiply(CsrMatrix<T>& A, SquareMatrix<T>& B, SquareMatrix<Accumulator>* C) = 0;
+
+    /**
+     * C = A * B, all matrices being sparse
+     */
+    virtual void multiply(CsrMatrix<T>& A, CsrMatrix<T>& B, CsrMatrix<Accumulator>* C) = 0;
+
+    //! Empty virtual destructor, needed for correct polymorphism
+    virtual ~AbstractSparseMatrixMultiplier() {}
+
+    static auto getElementType()
+    {
+        return T{};
+    }
+
+    static auto getAccumulatorType()
+    {
+        return Accumulator{};
+    }
+};
+
+/**
+ * Noyaux de multiplication creuse, travaillant sur une plage de lignes
+ * [firstRow, lastRow[ de A afin de pouvoir être répartis entre threads.
+ */
+template<class Traits>
+struct SparseMultiplicationKernel
+{
+    using T = typename Traits::StorageType;
+    using Accumulator = typename Traits::AccumulatorType;
+
+    /**
+     * Résultat partiel d'une multiplication creuse pour une plage de lignes
+     */
+    struct RowsResult {
+        std::vector<int> rowLengths;
+        std::vector<int> columns;
+        std::vector<Accumulator> values;
+    };
+
+    /**
+     * SpMM: C[lignes] += A[lignes] * B, seuls les éléments non nuls de A
+     * sont parcourus
+     */
+    static void multiplyRows(CsrMatrix<T>& A, SquareMatrix<T>& B, SquareMatrix<Accumulator>* C,
+                             int firstRow, int lastRow)
+    {
+        for (int row = firstRow; row < lastRow; row++) {
+            for (int index = A.rowBegin(row); index < A.rowEnd(row); index++) {
+                int k = A.column(index);
+                Accumulator a = static_cast<Accumulator>(A.value(index));
+                for (int col = 0; col < B.size(); col++) {
+                    C->setElement(col, row, C->element(col, row) +
+                                  a * static_cast<Accumulator>(B.element(col, k)));
+                }
+            }
+        }
+    }
+
+    /**
+     * SpGEMM (algorithme de Gustavson): chaque ligne du résultat est
+     * accumulée dans un tableau dense, puis seules les colonnes touchées
+     * sont extraites, triées.
+     */
+    static void multiplyRows(CsrMatrix<T>& A, CsrMatrix<T>& B, RowsResult* result,
+                             int firstRow, int lastRow)
+    {
+        std::vector<Accumulator> accumulator(B.getSizeX(), Accumulator{});
+        std::vector<bool> used(B.getSizeX(), false);
+        std::vector<int> touched;
+
+        result->rowLengths.assign(lastRow - firstRow, 0);
+        for (int row = firstRow; row < lastRow; row++) {
+            for (int indexA = A.rowBegin(row); indexA < A.rowEnd(row); indexA++) {
+                int k = A.column(indexA);
+                Accumulator a = static_cast<Accumulator>(A.value(indexA));
+                for (int indexB = B.rowBegin(k); indexB < B.rowEnd(k); indexB++) {
+                    int col = B.column(indexB);
+                    if (!used[col]) {
+                        used[col] = true;
+                        touched.push_back(col);
+                    }
+                    accumulator[col] += a * static_cast<Accumulator>(B.value(indexB));
+                }
+            }
+
+            std::sort(touched.begin(), touched.end());
+            for (int col : touched) {
+                result->columns.push_back(col);
+                result->values.push_back(accumulator[col]);
+                accumulator[col] = Accumulator{};
+                used[col] = false;
+            }
+            result->rowLengths[row - firstRow] = touched.size();
+            touched.clear();
+        }
+    }
+
+    /**
+     * Assemble les résultats partiels, dans l'ordre des plages de lignes,
+     * en une matrice CSR
+     */
+    static void assemble(std::vector<RowsResult>& parts, CsrMatrix<Accumulator>* C)
+    {
+        std::vector<int> rowPointers(1, 0);
+        std::vector<int> columns;
+        std::vector<Accumulator> values;
+
+        size_t nbNonZeros = 0;
+        for (RowsResult& part : parts)
+            nbNonZeros += part.columns.size();
+        rowPointers.reserve(C->getSizeY() + 1);
+        columns.reserve(nbNonZeros);
+        values.reserve(nbNonZeros);
+
+        for (RowsResult& part : parts) {
+            for (int length : part.rowLengths)
+                rowPointers.push_back(rowPointers.back() + length);
+            columns.insert(columns.end(), part.columns.begin(), part.columns.end());
+            values.insert(values.end(), part.values.begin(), part.values.end());
+        }
+        C->assign(std::move(rowPointers), std::move(columns), std::move(values));
+    }
+};
+
+#endif // ABSTRACTSPARSEMATRIXMULTIPLIER_H
@@ -0,0 +1,153 @@
+#ifndef ACCUMULATIONTRAITS_H
+#define ACCUMULATIONTRAITS_H
+
+/*
+Auteurs: Alexandre Jaquier, Valentin Kaelin
+Date: 19.10.2026
+Description: Traits définissant le type dans lequel les produits scalaires
+             sont accumulés, ainsi que le noyau de calcul associé
+*/
+
+#include <cstdint>
+#include <vector>
+
+#include "matrix.h"
+
+/**
+ * Accumulation dans le type de stockage, comportement historique des
+ * multiplicateurs. Un dépassement sur des entiers n'est pas détecté.
+ */
+template<class T>
+struct SameAccumulation
+{
+    using StorageType = T;
+    using AccumulatorType = T;
+};
+
+/**
+ * Accumulation dans un type plus large que le type de stockage. Seules les
+ * paires pour lesquelles un type plus large a un sens sont définies, toute
+ * autre utilisation est refusée à la compilation.
+ * Les matrices d'entrée restent dans le type étroit, ce qui réduit la bande
+ * passante mémoire nécessaire à leur lecture.
+ */
+template<class T>
+struct WideAccumulation;
+
+template<>
+struct WideAccumulation<int8_t>
+{
+    using StorageType = int8_t;
+    using AccumulatorType = int32_t;
+};
+
+template<>
+struct WideAccumulation<int16_t>
+{
+    using StorageType = int16_t;
+    using AccumulatorType = int32_t;
+};
+
+template<>
+struct WideAccumulation<int32_t>
+{
+    using StorageType = int32_t;
+    using AccumulatorType = int64_t;
+};
+
+template<>
+struct WideAccumulation<float>
+{
+    using StorageType = float;
+    using AccumulatorType = double;
+};
+
+/**
+ * Noyau générique de multiplication d'un bloc, pour les paires
+ * (type de stockage, type d'accumulation) sans noyau spécialisé.
+ * Chaque produit scalaire est accumulé dans une variable locale du type
+ * d'accumulation: les opérandes sont convertis avant la multiplication afin
+ * que le produit lui-même ne puisse pas déborder du type de stockage.
+ */
+template<class Traits>
+struct MultiplicationKernel
+{
+    using T = typename Traits::StorageType;
+    using Accumulator = typename Traits::AccumulatorType;
+
+    /**
+     * C[bloc] += A * B pour les lignes [rowIndex, rowIndex + nbRows[ et les
+     * colonnes [colIndex, colIndex + nbCols[ de C
+     */
+    static void multiplyBlock(SquareMatrix<T>& A, SquareMatrix<T>& B, SquareMatrix<Accumulator>* C,
+                              int rowIndex, int colIndex, int nbRows, int nbCols)
+    {
+        for (int row = rowIndex; row < rowIndex + nbRows; row++) {
+            for (int col = colIndex; col < colIndex + nbCols; col++) {
+                Accumulator sum = C->element(col, row);
+                for (int k = 0; k < A.size(); k++) {
+                    sum += static_cast<Accumulator>(A.element(k, row)) *
+                           static_cast<Accumulator>(B.element(col, k));
+                }
+                C->setElement(col, row, sum);
+            }
+        }
+    }
+};
+
+/**
+ * Noyau des entiers étroits (int8_t, int16_t) accumulés en int32_t.
+ * Les lignes de A et les colonnes de B du bloc sont d'abord élargies dans des
+ * tampons contigus: la boucle interne devient un produit scalaire sur deux
+ * tableaux d'int32_t adjacents, que le compilateur vectorise, au lieu de
+ * parcourir B colonne par colonne et de convertir chaque opérande à chaque
+ * produit. Chaque élément n'est élargi qu'une fois par bloc.
+ */
+template<class Traits>
+struct WideningMultiplicationKernel
+{
+    using T = typename Traits::StorageType;
+    using Accumulator = typename Traits::AccumulatorType;
+
+    static void multiplyBlock(SquareMatrix<T>& A, SquareMatrix<T>& B, SquareMatrix<Accumulator>* C,
+                              int rowIndex, int colIndex, int nbRows, int nbCols)
+    {
+        const int n = A.size();
+
+        // Colonnes de B du bloc, transposées: colonne j dans [j * n, (j + 1) * n[
+        std::vector<Accumulator> columns(static_cast<size_t>(nbCols) * n);
+        for (int j = 0; j < nbCols; j++) {
+            for (int k = 0; k < n; k++) {
+                columns[static_cast<size_t>(j) * n + k] = B.element(colIndex + j, k);
+            }
+        }
+
+        std::vector<Accumulator> line(n);
+        for (int row = rowIndex; row < rowIndex + nbRows; row++) {
+            for (int k = 0; k < n; k++) {
+                line[k] = A.element(k, row);
+            }
+
+            for (int j = 0; j < nbCols; j++) {
+                const Accumulator* column = columns.data() + static_cast<size_t>(j) * n;
+                Accumulator sum = 0;
+                for (int k = 0; k < n; k++) {
+                    sum += line[k] * column[k];
+                }
+                C->setElement(colIndex + j, row, C->element(colIndex + j, row) + sum);
+            }
+        }
+    }
+};
+
+template<>
+struct MultiplicationKernel<WideAccumulation<int8_t>> : WideningMultiplicationKernel<WideAccumulation<int8_t>>
+{
+};
+
+template<>
+struct MultiplicationKernel<WideAccumulation<int16_t>> : WideningMultiplicationKernel<WideAccumulation<int16_t>>
+{
+};
+
+#endif // ACCUMULATIONTRAITS_H
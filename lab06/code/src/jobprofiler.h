@@ -0,0 +1,261 @@
+#ifndef JOBPROFILER_H
+#define JOBPROFILER_H
+
+/*
+Auteurs: Alexandre Jaquier, Valentin Kaelin
+Date: 19.10.2026
+Description: Instrumentation optionnelle du groupe de threads de travail.
+             Activée en définissant WORKERPOOL_PROFILING (qmake
+             CONFIG+=config_profiling), sans quoi les macros PROFILER_*
+             ne génèrent aucun code.
+*/
+
+#ifdef WORKERPOOL_PROFILING
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <pcosynchro/pcomutex.h>
+
+/**
+ * Collecte, pour chaque thread, les compteurs et la chronologie des Jobs.
+ * Chaque thread écrit uniquement dans son propre journal, enregistré une
+ * seule fois auprès du profileur lors de son premier événement: aucune
+ * écriture partagée n'a lieu pendant les calculs.
+ * Les fonctions de lecture (dump, print, reset) ne doivent être appelées
+ * que lorsqu'aucun calcul n'est en cours.
+ */
+class JobProfiler
+{
+public:
+    // Cycle de vie d'un Job, temps en nanosecondes
+    struct JobRecord {
+        int computation;
+        int64_t enqueued; // ajout dans le buffer
+        int64_t dequeued; // récupération par un thread, début du calcul
+        int64_t computed; // fin du calcul
+        int64_t finished; // fin annoncée au buffer
+    };
+
+    // Intervalle de temps d'un thread, attente ou calcul complet
+    struct Interval {
+        int computation;
+        int64_t start;
+        int64_t end;
+    };
+
+    struct Counters {
+        uint64_t nbJobs = 0;
+        int64_t queueWaitNs = 0; // ajout -> récupération des Jobs
+        int64_t computeNs = 0; // calcul des Jobs
+        int64_t completionNs = 0; // ajout -> fin des Jobs
+        int64_t idleNs = 0; // threads bloqués en attente d'un Job
+        int64_t lockWaitNs = 0; // attente du mutex du buffer
+        int64_t lockHoldNs = 0; // détention du mutex du buffer
+    };
+
+    struct ThreadLog {
+        int tid;
+        std::vector<JobRecord> jobs;
+        std::vector<Interval> idle;
+        std::vector<Interval> computations;
+        Counters counters;
+
+        /**
+         * Ajoute le temps écoulé depuis start à un compteur
+         */
+        void add(int64_t Counters::*counter, int64_t start)
+        {
+            counters.*counter += now() - start;
+        }
+
+        void jobFinished(int computation, int64_t enqueued, int64_t dequeued, int64_t computed)
+        {
+            int64_t finished = now();
+            jobs.push_back({computation, enqueued, dequeued, computed, finished});
+            counters.nbJobs++;
+            counters.queueWaitNs += dequeued - enqueued;
+            counters.computeNs += computed - dequeued;
+            counters.completionNs += finished - enqueued;
+        }
+
+        void idleInterval(int64_t start)
+        {
+            int64_t end = now();
+            idle.push_back({-1, start, end});
+            counters.idleNs += end - start;
+        }
+
+        void computationStarted(int computation)
+        {
+            computations.push_back({computation, now(), 0});
+        }
+
+        void computationFinished(int computation)
+        {
+            for (auto it = computations.rbegin(); it != computations.rend(); ++it) {
+                if (it->computation == computation && it->end == 0) {
+                    it->end = now();
+                    return;
+                }
+            }
+        }
+    };
+
+    /**
+     * Temps écoulé depuis le démarrage du profileur, en nanosecondes
+     */
+    static int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - epoch()).count();
+    }
+
+    /**
+     * Journal du thread appelant, créé et enregistré au premier appel
+     */
+    static ThreadLog& local()
+    {
+        thread_local ThreadLog* log = registerThread();
+        return *log;
+    }
+
+    /**
+     * Écrit la chronologie de tous les threads au format Chrome trace
+     * (chrome://tracing ou https://ui.perfetto.dev)
+     * @param path fichier JSON à écrire
+     */
+    static void dumpChromeTrace(const std::string& path)
+    {
+        std::ofstream out(path);
+        bool first = true;
+        auto separator = [&]() -> std::ostream& {
+            if (!first)
+                out << ",\n";
+            first = false;
+            return out;
+        };
+        auto complete = [&](const char* name, int tid, int computation, int64_t start, int64_t end) {
+            separator() << "{\"name\":\"" << name << "\",\"cat\":\"workerpool\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+                        << ",\"ts\":" << start / 1000.0 << ",\"dur\":" << (end - start) / 1000.0
+                        << ",\"args\":{\"computation\":" << computation << "}}";
+        };
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        registryMutex().lock();
+        uint64_t jobId = 0;
+        for (auto& log : registry()) {
+            separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << log->tid
+                        << ",\"args\":{\"name\":\"thread " << log->tid << "\"}}";
+            for (Interval& interval : log->computations)
+                if (interval.end != 0)
+                    complete("multiply", log->tid, interval.computation, interval.start, interval.end);
+            for (Interval& interval : log->idle)
+                complete("idle", log->tid, interval.computation, interval.start, interval.end);
+            for (JobRecord& job : log->jobs) {
+                complete("compute", log->tid, job.computation, job.dequeued, job.computed);
+                // Durée de vie complète du Job, de son ajout à sa fin
+                separator() << "{\"name\":\"job\",\"cat\":\"job\",\"ph\":\"b\",\"pid\":1,\"tid\":" << log->tid
+                            << ",\"id\":" << jobId << ",\"ts\":" << job.enqueued / 1000.0
+                            << ",\"args\":{\"computation\":" << job.computation << "}}";
+                separator() << "{\"name\":\"job\",\"cat\":\"job\",\"ph\":\"e\",\"pid\":1,\"tid\":" << log->tid
+                            << ",\"id\":" << jobId << ",\"ts\":" << job.finished / 1000.0 << "}";
+                jobId++;
+            }
+        }
+        registryMutex().unlock();
+        out << "\n]}\n";
+    }
+
+    /**
+     * Affiche les compteurs de chaque thread, en millisecondes
+     */
+    static void printCounters(std::ostream& out)
+    {
+        registryMutex().lock();
+        for (auto& log : registry()) {
+            const Counters& c = log->counters;
+            out << "Thread " << log->tid << ": " << c.nbJobs << " jobs"
+                << ", queue wait " << c.queueWaitNs / 1e6 << " ms"
+                << ", compute " << c.computeNs / 1e6 << " ms"
+                << ", completion " << c.completionNs / 1e6 << " ms"
+                << ", idle " << c.idleNs / 1e6 << " ms"
+                << ", lock wait " << c.lockWaitNs / 1e6 << " ms"
+                << ", lock hold " << c.lockHoldNs / 1e6 << " ms" << std::endl;
+        }
+        registryMutex().unlock();
+    }
+
+    /**
+     * Vide les journaux de tous les threads
+     */
+    static void reset()
+    {
+        registryMutex().lock();
+        for (auto& log : registry()) {
+            log->jobs.clear();
+            log->idle.clear();
+            log->computations.clear();
+            log->counters = Counters();
+        }
+        registryMutex().unlock();
+    }
+
+private:
+    static std::chrono::steady_clock::time_point epoch()
+    {
+        static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        return start;
+    }
+
+    static PcoMutex& registryMutex()
+    {
+        static PcoMutex mutex;
+        return mutex;
+    }
+
+    // Les journaux survivent à leur thread afin de pouvoir être lus après coup
+    static std::vector<std::unique_ptr<ThreadLog>>& registry()
+    {
+        static std::vector<std::unique_ptr<ThreadLog>> logs;
+        return logs;
+    }
+
+    static ThreadLog* registerThread()
+    {
+        epoch();
+        registryMutex().lock();
+        std::vector<std::unique_ptr<ThreadLog>>& logs = registry();
+        logs.emplace_back(new ThreadLog());
+        ThreadLog* log = logs.back().get();
+        log->tid = logs.size();
+        registryMutex().unlock();
+        return log;
+    }
+};
+
+#define PROFILER_START(variable) const int64_t variable = JobProfiler::now()
+#define PROFILER_ADD(counter, start) JobProfiler::local().add(&JobProfiler::Counters::counter, start)
+#define PROFILER_IDLE(start) JobProfiler::local().idleInterval(start)
+#define PROFILER_JOB_FINISHED(computation, enqueued, dequeued, computed) \
+    JobProfiler::local().jobFinished(computation, enqueued, dequeued, computed)
+#define PROFILER_COMPUTATION_STARTED(computation) JobProfiler::local().computationStarted(computation)
+#define PROFILER_COMPUTATION_FINISHED(computation) JobProfiler::local().computationFinished(computation)
+
+#else
+
+#define PROFILER_START(variable)
+#define PROFILER_ADD(counter, start)
+#define PROFILER_IDLE(start)
+#define PROFILER_JOB_FINISHED(computation, enqueued, dequeued, computed)
+#define PROFILER_COMPUTATION_STARTED(computation)
+#define PROFILER_COMPUTATION_FINISHED(computation)
+
+#endif // WORKERPOOL_PROFILING
+
+#endif // JOBPROFILER_H
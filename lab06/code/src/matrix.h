@@ -56,8 +56,9 @@ public:
     /**
      * This function simply compares two matrices and display the first
      * unmatching element if there exist one.
+     * Returns true if both matrices are equal.
      */
-    void compare(Matrix<T>& other)
+    bool compare(Matrix<T>& other)
     {
         for (int i = 0; i < getSizeX(); i++) {
             for (int j = 0; j < getSizeY(); j++) {
@@ -65,11 +66,12 @@ public:
                     std::cout << "Error in matrix calculation" << std::endl;
                     std::cout << "i= " << i << "j= " << j << "M1(i,j)= " << this->element(i, j)
                               << "M2(i,j)= " << other.element(i, j) << std::endl;
-                    return;
+                    return false;
                 }
             }
         }
         std::cout << "No error in calculus" << std::endl;
+        return true;
     }
 
 protected:
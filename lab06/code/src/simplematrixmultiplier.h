@@ -6,19 +6,15 @@
 /**
  * A simple implementation of the matrix multiplication.
  */
-template<class T>
-class SimpleMatrixMultiplier : public AbstractMatrixMultiplier<T>
+template<class T, class Traits = SameAccumulation<T>>
+class SimpleMatrixMultiplier : public AbstractMatrixMultiplier<T, Traits>
 {
 public:
-    void multiply(SquareMatrix<T>& A, SquareMatrix<T>& B, SquareMatrix<T>* C)
+    using Accumulator = typename Traits::AccumulatorType;
+
+    void multiply(SquareMatrix<T>& A, SquareMatrix<T>& B, SquareMatrix<Accumulator>* C)
     {
-        for (int i = 0; i < A.size(); i++) {
-            for (int j = 0; j < A.size(); j++) {
-                for (int k = 0; k < A.size(); k++) {
-                    C->setElement(i, j, C->element(i, j) + A.element(k, j) * B.element(i, k));
-                }
-            }
-        }
+        MultiplicationKernel<Traits>::multiplyBlock(A, B, C, 0, 0, A.size(), A.size());
     }
 };
 
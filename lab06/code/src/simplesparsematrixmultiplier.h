@@ -0,0 +1,31 @@
+#ifndef SIMPLESPARSEMATRIXMULTIPLIER_H
+#define SIMPLESPARSEMATRIXMULTIPLIER_H
+
+#include "abstractsparsematrixmultiplier.h"
+
+/**
+ * A simple implementation of the sparse matrix multiplications.
+ */
+template<class T, class Traits = SameAccumulation<T>>
+class SimpleSparseMatrixMultiplier : public AbstractSparseMatrixMultiplier<T, Traits>
+{
+    using Kernel = SparseMultiplicationKernel<Traits>;
+
+public:
+    using Accumulator = typename Traits::AccumulatorType;
+
+    void multiply(CsrMatrix<T>& A, SquareMatrix<T>& B, SquareMatrix<Accumulator>* C)
+    {
+        Kernel::multiplyRows(A, B, C, 0, A.getSizeY());
+    }
+
+    void multiply(CsrMatrix<T>& A, CsrMatrix<T>& B, CsrMatrix<Accumulator>* C)
+    {
+        std::vector<typename Kernel::RowsResult> parts(1);
+        Kernel::multiplyRows(A, B, &parts[0], 0, A.getSizeY());
+        Kernel::assemble(parts, C);
+    }
+};
+
+
+#endif // SIMPLESPARSEMATRIXMULTIPLIER_H
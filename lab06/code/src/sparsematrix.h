@@ -0,0 +1,141 @@
+#ifndef SPARSEMATRIX_H
+#define SPARSEMATRIX_H
+
+/*
+Auteurs: Alexandre Jaquier, Valentin Kaelin
+Date: 19.10.2026
+Description: Matrice creuse au format CSR (Compressed Sparse Row)
+*/
+
+#include <vector>
+
+#include "matrix.h"
+
+/**
+ * Matrice creuse stockée ligne par ligne: pour chaque ligne y, les éléments
+ * non nuls sont rangés aux index [rowPointers[y], rowPointers[y + 1][ des
+ * tableaux columns (colonne x de l'élément) et values, par colonne croissante.
+ * Le format CSC d'une matrice correspond au format CSR de sa transposée,
+ * obtenu avec transposed().
+ */
+template<class T>
+class CsrMatrix
+{
+public:
+    CsrMatrix(int sx, int sy) : rowPointers(sy + 1, 0), columns(), values(), sizeX(sx), sizeY(sy) {}
+
+    /**
+     * Construit la matrice creuse contenant les éléments non nuls d'une
+     * matrice dense
+     */
+    static CsrMatrix<T> fromDense(Matrix<T>& dense)
+    {
+        CsrMatrix<T> sparse(dense.getSizeX(), dense.getSizeY());
+        for (int y = 0; y < dense.getSizeY(); y++) {
+            for (int x = 0; x < dense.getSizeX(); x++) {
+                T value = dense.element(x, y);
+                if (value != T{}) {
+                    sparse.columns.push_back(x);
+                    sparse.values.push_back(value);
+                }
+            }
+            sparse.rowPointers[y + 1] = sparse.columns.size();
+        }
+        return sparse;
+    }
+
+    /**
+     * Écrit tous les éléments de la matrice, nuls compris, dans une matrice
+     * dense de même taille
+     */
+    void toDense(Matrix<T>* dense) const
+    {
+        for (int y = 0; y < sizeY; y++) {
+            for (int x = 0; x < sizeX; x++)
+                dense->setElement(x, y, T{});
+            for (int index = rowBegin(y); index < rowEnd(y); index++)
+                dense->setElement(columns[index], y, values[index]);
+        }
+    }
+
+    /**
+     * Retourne la transposée, soit la représentation CSC de cette matrice
+     */
+    CsrMatrix<T> transposed() const
+    {
+        CsrMatrix<T> result(sizeY, sizeX);
+        result.columns.resize(nbNonZeros());
+        result.values.resize(nbNonZeros());
+
+        // Comptage des éléments de chaque colonne, puis somme préfixe
+        for (int column : columns)
+            result.rowPointers[column + 1]++;
+        for (int x = 0; x < sizeX; x++)
+            result.rowPointers[x + 1] += result.rowPointers[x];
+
+        // Parcours par ligne croissante: les colonnes du résultat restent triées
+        std::vector<int> nextIndex(result.rowPointers.begin(), result.rowPointers.end() - 1);
+        for (int y = 0; y < sizeY; y++) {
+            for (int index = rowBegin(y); index < rowEnd(y); index++) {
+                int destination = nextIndex[columns[index]]++;
+                result.columns[destination] = y;
+                result.values[destination] = values[index];
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Remplace le contenu de la matrice par des tableaux CSR déjà construits
+     */
+    void assign(std::vector<int> newRowPointers, std::vector<int> newColumns, std::vector<T> newValues)
+    {
+        rowPointers = std::move(newRowPointers);
+        columns = std::move(newColumns);
+        values = std::move(newValues);
+    }
+
+    inline int rowBegin(int y) const
+    {
+        return rowPointers[y];
+    }
+
+    inline int rowEnd(int y) const
+    {
+        return rowPointers[y + 1];
+    }
+
+    inline int column(int index) const
+    {
+        return columns[index];
+    }
+
+    inline T value(int index) const
+    {
+        return values[index];
+    }
+
+    int nbNonZeros() const
+    {
+        return columns.size();
+    }
+
+    int getSizeX() const
+    {
+        return sizeX;
+    }
+
+    int getSizeY() const
+    {
+        return sizeY;
+    }
+
+protected:
+    std::vector<int> rowPointers;
+    std::vector<int> columns;
+    std::vector<T> values;
+    int sizeX;
+    int sizeY;
+};
+
+#endif // SPARSEMATRIX_H
@@ -0,0 +1,137 @@
+#ifndef THREADEDSPARSEMATRIXMULTIPLIER_H
+#define THREADEDSPARSEMATRIXMULTIPLIER_H
+
+/*
+Auteurs: Alexandre Jaquier, Valentin Kaelin
+Date: 19.10.2026
+Description: Version multi-thread de la multiplication de matrices creuses
+*/
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "abstractsparsematrixmultiplier.h"
+#include "workerpool.h"
+
+///
+/// A multi-threaded sparse multiplicator. The rows of A are split into
+/// ranges holding roughly the same number of non zero elements, each range
+/// being a Job of the worker pool. multiply() is reentrant.
+///
+template<class T, class Traits = SameAccumulation<T>>
+class ThreadedSparseMatrixMultiplier : public AbstractSparseMatrixMultiplier<T, Traits>
+{
+    using Kernel = SparseMultiplicationKernel<Traits>;
+
+public:
+    using Accumulator = typename Traits::AccumulatorType;
+
+    ///
+    /// \brief ThreadedSparseMatrixMultiplier
+    /// \param nbThreads Minimal number of threads of the shared worker pool
+    /// \param nbBlocks Number of row ranges A is split into
+    ///
+    ThreadedSparseMatrixMultiplier(int nbThreads, int nbBlocks)
+        : m_nbBlocks(nbBlocks), pool(WorkerPool::shared(nbThreads))
+    {
+    }
+
+    ///
+    /// \brief ThreadedSparseMatrixMultiplier
+    /// \param pool Worker pool executing the jobs
+    /// \param nbBlocks Number of row ranges A is split into
+    ///
+    ThreadedSparseMatrixMultiplier(std::shared_ptr<WorkerPool> pool, int nbBlocks)
+        : m_nbBlocks(nbBlocks), pool(std::move(pool))
+    {
+    }
+
+    ///
+    /// \brief multiply
+    /// \param A First matrix, sparse
+    /// \param B Second matrix, dense
+    /// \param C Result of AxB, dense
+    ///
+    void multiply(CsrMatrix<T>& A, SquareMatrix<T>& B, SquareMatrix<Accumulator>* C)
+    {
+        std::vector<int> bounds = partitionRows(A);
+        int nbTotalJobs = bounds.size() - 1;
+        int id = pool->startComputation();
+
+        for (int i = 0; i < nbTotalJobs; ++i) {
+            int firstRow = bounds[i];
+            int lastRow = bounds[i + 1];
+            pool->sendJob(id, nbTotalJobs, [&A, &B, C, firstRow, lastRow]() {
+                Kernel::multiplyRows(A, B, C, firstRow, lastRow);
+            });
+        }
+
+        pool->waitJobsFinished(id, nbTotalJobs);
+    }
+
+    ///
+    /// \brief multiply
+    /// \param A First matrix, sparse
+    /// \param B Second matrix, sparse
+    /// \param C Result of AxB, sparse
+    ///
+    /// Each Job produces the rows of its range, they are then assembled in order.
+    void multiply(CsrMatrix<T>& A, CsrMatrix<T>& B, CsrMatrix<Accumulator>* C)
+    {
+        std::vector<int> bounds = partitionRows(A);
+        int nbTotalJobs = bounds.size() - 1;
+        std::vector<typename Kernel::RowsResult> parts(nbTotalJobs);
+        int id = pool->startComputation();
+
+        for (int i = 0; i < nbTotalJobs; ++i) {
+            int firstRow = bounds[i];
+            int lastRow = bounds[i + 1];
+            auto* part = &parts[i];
+            pool->sendJob(id, nbTotalJobs, [&A, &B, part, firstRow, lastRow]() {
+                Kernel::multiplyRows(A, B, part, firstRow, lastRow);
+            });
+        }
+
+        pool->waitJobsFinished(id, nbTotalJobs);
+        Kernel::assemble(parts, C);
+    }
+
+protected:
+    /**
+     * Découpe les lignes de A en au plus m_nbBlocks plages contiguës
+     * contenant à peu près le même nombre d'éléments non nuls.
+     * @return les bornes des plages, la plage i étant [bounds[i], bounds[i + 1][
+     */
+    std::vector<int> partitionRows(CsrMatrix<T>& A)
+    {
+        int nbRows = A.getSizeY();
+        int nbBlocks = std::max(1, std::min(m_nbBlocks, nbRows));
+        long nbNonZeros = A.nbNonZeros();
+
+        std::vector<int> bounds(1, 0);
+        for (int block = 1; block < nbBlocks; ++block) {
+            long target = nbNonZeros * block / nbBlocks;
+            // Première ligne dont le début atteint la cible
+            int low = bounds.back(), high = nbRows;
+            while (low < high) {
+                int middle = (low + high) / 2;
+                if (A.rowBegin(middle) < target)
+                    low = middle + 1;
+                else
+                    high = middle;
+            }
+            // Les plages vides sont ignorées
+            if (low > bounds.back() && low < nbRows)
+                bounds.push_back(low);
+        }
+        bounds.push_back(nbRows);
+        return bounds;
+    }
+
+    int m_nbBlocks;
+    std::shared_ptr<WorkerPool> pool;
+};
+
+
+#endif // THREADEDSPARSEMATRIXMULTIPLIER_H
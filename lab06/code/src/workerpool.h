@@ -0,0 +1,369 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+/*
+Auteurs: Alexandre Jaquier, Valentin Kaelin
+Date: 19.10.2026
+Description: Groupe de threads de travail exécutant des Jobs regroupés par
+             calcul. Partagé par les multiplicateurs denses et creux.
+*/
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include <QList>
+#include <QMap>
+#include <QSharedPointer>
+
+#include <pcosynchro/pcoconditionvariable.h>
+#include <pcosynchro/pcomutex.h>
+#include <pcosynchro/pcothread.h>
+
+#include "jobprofiler.h"
+
+/**
+ * Threads de travail récupérant des Jobs dans un buffer commun.
+ * Chaque Job appartient à un calcul identifié par un id, ce qui permet
+ * à plusieurs threads d'effectuer des calculs en parallèle sur le même
+ * groupe (réentrance) et d'attendre uniquement la fin de leurs propres Jobs.
+ *
+ * Un groupe partagé par tout le processus est disponible via shared(): il
+ * est démarré au premier usage et arrêté à la fin du programme, si bien que
+ * créer un multiplicateur ne crée plus aucun thread.
+ */
+class WorkerPool
+{
+    // Structure d'un Job
+    struct Job {
+        int id; // id du calcul
+        int nbTotalJobs; // nombre de jobs pour le calcul
+        std::function<void()> work; // travail à réaliser
+#ifdef WORKERPOOL_PROFILING
+        int64_t enqueued; // instant de l'ajout dans le buffer
+#endif
+    };
+
+    /**
+     * Classe servant à communiquer entre le thread principal et les différents workers.
+     * Réalisé à l'aide de moniteurs de Mesa afin de pouvoir réveiller facilement tous
+     * threads en attente d'un Job.
+     */
+    class Buffer
+    {
+    private:
+        // Mutex gérant la gestion de l'envoi et la réception de job
+        PcoMutex mutex;
+        // Condition gérant la gestion de l'envoi et la réception de job
+        PcoConditionVariable cond;
+        QList<Job> jobs;
+        // Map stockant pour chaque calcul le nombre de jobs fini
+        QMap<int, int> nbJobsFinished;
+        // Map stockant pour chaque calcul la condition permettant de stopper le thread principal
+        QMap<int, QSharedPointer<PcoConditionVariable>> waitingMasters;
+    public:
+        Buffer() : jobs(), nbJobsFinished(), waitingMasters() {}
+
+        ~Buffer() {
+            // Supprime les allocations créées
+            if (!waitingMasters.isEmpty())
+                waitingMasters.clear();
+        }
+
+        /**
+         * Ajoute un Job dans la liste des jobs à réaliser
+         * @param job : Job à réaliser
+         */
+        void sendJob(Job job) {
+            PROFILER_START(lockRequested);
+            mutex.lock();
+            PROFILER_ADD(lockWaitNs, lockRequested);
+            PROFILER_START(lockAcquired);
+            jobs.append(job);
+            // Annonce qu'un nouveau job est disponible
+            cond.notifyOne();
+            PROFILER_ADD(lockHoldNs, lockAcquired);
+            mutex.unlock();
+        }
+
+        /**
+         * Retourne le Job le plus ancien et le supprime de la liste des jobs
+         * à réaliser. Si aucun Job n'est disponible, la fonction bloque en
+         * attendant un nouveau Job.
+         * @return le Job à réaliser
+         */
+        Job getJob() {
+            Job job;
+            PROFILER_START(lockRequested);
+            mutex.lock();
+            PROFILER_ADD(lockWaitNs, lockRequested);
+            while (jobs.empty()) {
+                if (PcoThread::thisThread()->stopRequested())
+                    break;
+
+                cond.wait(&mutex);
+            }
+            PROFILER_START(lockAcquired);
+            if (jobs.size() > 0) {
+                job = jobs.first();
+                jobs.removeFirst();
+            }
+            PROFILER_ADD(lockHoldNs, lockAcquired);
+            mutex.unlock();
+            return job;
+        }
+
+        /**
+         * Initie un nouveau calcul en mettant un état initial aux différentes
+         * structures utilisées
+         * @param id du calcul à initialiser
+         */
+        void initNewComputation(int id) {
+            mutex.lock();
+            nbJobsFinished.insert(id, 0);
+            waitingMasters.insert(id, (QSharedPointer<PcoConditionVariable>)new PcoConditionVariable());
+            mutex.unlock();
+        }
+
+        /**
+         * Attend que tous les jobs d'un calcul soient terminés via un moniteur de Mesa.
+         * @param id du calcul à vérifier
+         * @param nbTotalJobs nombre de Jobs total à réaliser pour le calcul
+         */
+        void waitJobsFinished(int id, int nbTotalJobs) {
+            mutex.lock();
+            while (nbTotalJobs != nbJobsFinished[id]) {
+                waitingMasters[id]->wait(&mutex);
+            }
+            // Suppression des informations concernant le calcul terminé
+            nbJobsFinished.remove(id);
+            waitingMasters.remove(id); // Va également supprimer le QSharedPointer
+            mutex.unlock();
+        }
+
+        /**
+         * Annonce au buffer qu'un thread a terminé un Job
+         * @param id du calcul
+         * @param nbTotalJobs nombre de Jobs total à réaliser pour le calcul
+         */
+        void finishedJob(int id, int nbTotalJobs) {
+            PROFILER_START(lockRequested);
+            mutex.lock();
+            PROFILER_ADD(lockWaitNs, lockRequested);
+            PROFILER_START(lockAcquired);
+            // Si tous les jobs sont terminés, le thread principal est notifié
+            if (++nbJobsFinished[id] == nbTotalJobs)
+                waitingMasters[id]->notifyOne();
+            PROFILER_ADD(lockHoldNs, lockAcquired);
+            mutex.unlock();
+        }
+
+        /**
+         * Libère tous les threads bloqués en attente d'un Job
+         */
+        void freeAllThreads() {
+            cond.notifyAll();
+        }
+    };
+
+public:
+    /**
+     * Démarre le nombre de threads demandé
+     * @param nbThreads nombre de threads de travail
+     */
+    WorkerPool(int nbThreads) : counter(0), threads()
+    {
+        addThreads(nbThreads);
+    }
+
+    /**
+     * Demande l'arrêt des threads et attend leur terminaison.
+     * Les Jobs encore présents dans le buffer sont abandonnés.
+     */
+    ~WorkerPool()
+    {
+        // Annonce aux threads qu'ils doivent se terminer
+        for (QSharedPointer<PcoThread> &thread : threads)
+            thread->requestStop();
+
+        // Notifie tous les threads qui attendent pour avoir un Job
+        buffer.freeAllThreads();
+
+        // Attend que les threads se terminent sans erreur
+        for (QSharedPointer<PcoThread> &thread : threads)
+            thread->join();
+
+        // Supprime les allocations créées
+        if (!threads.isEmpty())
+            threads.clear();
+    }
+
+    /**
+     * Prépare un nouveau calcul
+     * @return l'identifiant à fournir à sendJob et waitJobsFinished
+     */
+    int startComputation()
+    {
+        int id;
+        counterMutex.lock();
+        id = counter++;
+        // Annonce au buffer qu'un nouveau calcul se prépare
+        buffer.initNewComputation(id);
+        counterMutex.unlock();
+        PROFILER_COMPUTATION_STARTED(id);
+        return id;
+    }
+
+    /**
+     * Ajoute un Job au calcul donné
+     * @param id du calcul
+     * @param nbTotalJobs nombre de Jobs total du calcul
+     * @param work travail à réaliser par un thread
+     */
+    void sendJob(int id, int nbTotalJobs, std::function<void()> work)
+    {
+#ifdef WORKERPOOL_PROFILING
+        buffer.sendJob({id, nbTotalJobs, std::move(work), JobProfiler::now()});
+#else
+        buffer.sendJob({id, nbTotalJobs, std::move(work)});
+#endif
+    }
+
+    /**
+     * Attend que tous les Jobs du calcul soient terminés
+     * @param id du calcul
+     * @param nbTotalJobs nombre de Jobs total du calcul
+     */
+    void waitJobsFinished(int id, int nbTotalJobs)
+    {
+        buffer.waitJobsFinished(id, nbTotalJobs);
+        PROFILER_COMPUTATION_FINISHED(id);
+    }
+
+    int nbThreads() const
+    {
+        threadsMutex.lock();
+        int nb = threads.size();
+        threadsMutex.unlock();
+        return nb;
+    }
+
+    /**
+     * Retourne le groupe partagé par tout le processus, en le démarrant s'il
+     * ne l'est pas encore. Le groupe est agrandi si besoin pour compter au
+     * moins minThreads threads.
+     * @param minThreads nombre minimal de threads souhaité
+     */
+    static std::shared_ptr<WorkerPool> shared(int minThreads = 0)
+    {
+        sharedMutex().lock();
+        std::shared_ptr<WorkerPool>& pool = sharedInstance();
+        if (!pool) {
+            int nbThreads = sharedSize() > 0 ? sharedSize() : std::thread::hardware_concurrency();
+            pool = std::make_shared<WorkerPool>(std::max(std::max(nbThreads, minThreads), 1));
+        } else if (pool->nbThreads() < minThreads) {
+            pool->addThreads(minThreads - pool->nbThreads());
+        }
+        std::shared_ptr<WorkerPool> result = pool;
+        sharedMutex().unlock();
+        return result;
+    }
+
+    /**
+     * Fixe la taille du groupe partagé. Si un groupe de taille différente
+     * est déjà démarré, il est remplacé: les multiplicateurs déjà créés
+     * gardent l'ancien, arrêté lorsque le dernier d'entre eux est détruit.
+     * @param nbThreads nombre de threads, 0 pour le nombre de coeurs
+     */
+    static void configureShared(int nbThreads)
+    {
+        sharedMutex().lock();
+        sharedSize() = nbThreads;
+        std::shared_ptr<WorkerPool>& pool = sharedInstance();
+        if (pool && nbThreads > 0 && pool->nbThreads() != nbThreads)
+            pool.reset();
+        sharedMutex().unlock();
+    }
+
+    /**
+     * Relâche le groupe partagé. Ses threads sont arrêtés dès qu'aucun
+     * multiplicateur ne l'utilise plus. Appelé automatiquement en fin de
+     * programme.
+     */
+    static void shutdownShared()
+    {
+        sharedMutex().lock();
+        sharedInstance().reset();
+        sharedMutex().unlock();
+    }
+
+private:
+    static PcoMutex& sharedMutex()
+    {
+        static PcoMutex mutex;
+        return mutex;
+    }
+
+    // Détruit, donc arrêté et joint, à la fin du programme
+    static std::shared_ptr<WorkerPool>& sharedInstance()
+    {
+        static std::shared_ptr<WorkerPool> pool;
+        return pool;
+    }
+
+    static int& sharedSize()
+    {
+        static int size = 0;
+        return size;
+    }
+
+    /**
+     * Démarre des threads supplémentaires
+     * @param nbThreads nombre de threads à ajouter
+     */
+    void addThreads(int nbThreads)
+    {
+        threadsMutex.lock();
+        for (int i = 0; i < nbThreads; ++i)
+            threads.append(
+                        (QSharedPointer<PcoThread>)new PcoThread(&WorkerPool::threadRun, this)
+                        );
+        threadsMutex.unlock();
+    }
+
+    /**
+     * Fonction exécutée par les différents threads
+     * S'occupe de récupérer un Job, puis de réaliser le travail.
+     * Annonce au buffer une fois ce Job terminé.
+     */
+    void threadRun() {
+        while (1) {
+            PROFILER_START(idleStart);
+            Job job = buffer.getJob();
+            PROFILER_IDLE(idleStart);
+
+            // Si le thread doit être arrêté, il sort de la boucle
+            if (PcoThread::thisThread()->stopRequested())
+                return;
+
+            PROFILER_START(dequeued);
+            job.work();
+            PROFILER_START(computed);
+
+            // Annonce que le Job est terminé
+            buffer.finishedJob(job.id, job.nbTotalJobs);
+            PROFILER_JOB_FINISHED(job.id, job.enqueued, dequeued, computed);
+        }
+    }
+
+    int counter; // permet de générer un identifiant unique pour chaque calcul
+    Buffer buffer;
+    PcoMutex counterMutex; // permet de protéger la variable counter
+    // permet de protéger threads, agrandi par shared() pendant que d'autres
+    // utilisateurs du groupe lisent sa taille
+    mutable PcoMutex threadsMutex;
+    QList<QSharedPointer<PcoThread>> threads;
+};
+
+#endif // WORKERPOOL_H
@@ -11,9 +11,13 @@ Description: Ajouts de quelques tests
 
 #include "multipliertester.h"
 #include "multiplierthreadedtester.h"
+#include "sparsemultipliertester.h"
 #include "src/threadedmatrixmultiplier.h"
 
 #define ThreadedMultiplierType ThreadedMatrixMultiplier<int>
+#define WideThreadedMultiplierType ThreadedMatrixMultiplier<int, WideAccumulation<int>>
+#define WideInt8ThreadedMultiplierType ThreadedMatrixMultiplier<int8_t, WideAccumulation<int8_t>>
+#define SparseMultiplierType ThreadedSparseMatrixMultiplier<int, WideAccumulation<int>>
 
 // Decommenting the next line allows to check for interlocking
 #define CHECK_DURATION
@@ -30,8 +34,11 @@ TEST(Multiplier, TestSmallValues){
                                constexpr int MAX_VALUE = 10;
 
                                MultiplierTester<ThreadedMultiplierType> tester;
+                               // Le groupe partagé ne fait que grandir: un groupe dédié garantit un seul thread
+                               std::shared_ptr<WorkerPool> pool = std::make_shared<WorkerPool>(NBTHREADS);
+                               ASSERT_EQ(pool->nbThreads(), 1);
 
-                               tester.test_values_limited(MATRIXSIZE, NBTHREADS, NBBLOCKSPERROW, MAX_VALUE);
+                               tester.test_values_limited(MATRIXSIZE, NBTHREADS, NBBLOCKSPERROW, MAX_VALUE, pool);
 
 #ifdef CHECK_DURATION
                            }))
@@ -60,8 +67,10 @@ TEST(Multiplier, SingleThread){
                                constexpr int NBBLOCKSPERROW = 5;
 
                                MultiplierTester<ThreadedMultiplierType> tester;
+                               std::shared_ptr<WorkerPool> pool = std::make_shared<WorkerPool>(NBTHREADS);
+                               ASSERT_EQ(pool->nbThreads(), 1);
 
-                               tester.test(MATRIXSIZE, NBTHREADS, NBBLOCKSPERROW);
+                               tester.test(MATRIXSIZE, NBTHREADS, NBBLOCKSPERROW, pool);
 
 #ifdef CHECK_DURATION
                            }))
@@ -109,10 +118,162 @@ TEST(Multiplier, Reentering)
 #endif // CHECK_DURATION
 }
 
+// Produits dépassant la capacité d'un int, accumulés sur 64 bits
+TEST(Multiplier, WideAccumulation){
+
+#ifdef CHECK_DURATION
+        ASSERT_DURATION_LE(30, ({
+#endif // CHECK_DURATION
+                               constexpr int MATRIXSIZE = 200;
+                               constexpr int NBTHREADS = 4;
+                               constexpr int NBBLOCKSPERROW = 5;
+                               constexpr int MAX_VALUE = 1 << 20;
+
+                               MultiplierTester<WideThreadedMultiplierType> tester;
+
+                               tester.test_values_limited(MATRIXSIZE, NBTHREADS, NBBLOCKSPERROW, MAX_VALUE);
+
+#ifdef CHECK_DURATION
+                           }))
+#endif // CHECK_DURATION
+
+}
+
+// Stockage sur 8 bits, accumulation sur 32 bits
+TEST(Multiplier, WideAccumulationInt8){
+
+#ifdef CHECK_DURATION
+        ASSERT_DURATION_LE(30, ({
+#endif // CHECK_DURATION
+                               constexpr int MATRIXSIZE = 200;
+                               constexpr int NBTHREADS = 4;
+                               constexpr int NBBLOCKSPERROW = 4;
+                               constexpr int MAX_VALUE = 127;
+
+                               MultiplierTester<WideInt8ThreadedMultiplierType> tester;
+
+                               tester.test_values_limited(MATRIXSIZE, NBTHREADS, NBBLOCKSPERROW, MAX_VALUE);
+
+#ifdef CHECK_DURATION
+                           }))
+#endif // CHECK_DURATION
+
+}
+
+// Vérifie la valeur exacte d'un produit qui déborderait un int
+TEST(Multiplier, WideAccumulationNoOverflow){
+                               constexpr int MATRIXSIZE = 16;
+                               constexpr int NBTHREADS = 2;
+                               constexpr int NBBLOCKSPERROW = 4;
+                               constexpr int VALUE = 1 << 20;
+
+                               SquareMatrix<int> A(MATRIXSIZE);
+                               SquareMatrix<int> B(MATRIXSIZE);
+                               SquareMatrix<int64_t> C(MATRIXSIZE);
+                               for (int i = 0; i < MATRIXSIZE; i++) {
+                                   for (int j = 0; j < MATRIXSIZE; j++) {
+                                       A.setElement(i, j, VALUE);
+                                       B.setElement(i, j, VALUE);
+                                       C.setElement(i, j, 0);
+                                   }
+                               }
+
+                               WideThreadedMultiplierType multiplier(NBTHREADS, NBBLOCKSPERROW);
+                               multiplier.multiply(A, B, &C);
+
+                               const int64_t expected = int64_t(MATRIXSIZE) * VALUE * VALUE;
+                               for (int i = 0; i < MATRIXSIZE; i++)
+                                   for (int j = 0; j < MATRIXSIZE; j++)
+                                       ASSERT_EQ(C.element(i, j), expected);
+}
+
+// Matrices creuses (95% de zéros), un seul thread: le groupe partagé pouvant
+// déjà en compter plusieurs, le multiplicateur reçoit son propre groupe
+TEST(Multiplier, SparseSingleThread){
+
+#ifdef CHECK_DURATION
+        ASSERT_DURATION_LE(30, ({
+#endif // CHECK_DURATION
+                               constexpr int MATRIXSIZE = 300;
+                               constexpr int NBTHREADS = 1;
+                               constexpr int NBBLOCKS = 4;
+                               constexpr double DENSITY = 0.05;
+
+                               SparseMultiplierTester<SparseMultiplierType> tester;
+                               std::shared_ptr<WorkerPool> pool = std::make_shared<WorkerPool>(NBTHREADS);
+                               ASSERT_EQ(pool->nbThreads(), 1);
+
+                               EXPECT_TRUE(tester.test(MATRIXSIZE, NBTHREADS, NBBLOCKS, DENSITY, pool));
+
+#ifdef CHECK_DURATION
+                           }))
+#endif // CHECK_DURATION
+
+}
+
+// Matrices très creuses (99% de zéros), plusieurs threads
+TEST(Multiplier, Sparse){
+
+#ifdef CHECK_DURATION
+        ASSERT_DURATION_LE(30, ({
+#endif // CHECK_DURATION
+                               constexpr int MATRIXSIZE = 1000;
+                               constexpr int NBTHREADS = 4;
+                               constexpr int NBBLOCKS = 16;
+                               constexpr double DENSITY = 0.01;
+
+                               SparseMultiplierTester<SparseMultiplierType> tester;
+
+                               EXPECT_TRUE(tester.test(MATRIXSIZE, NBTHREADS, NBBLOCKS, DENSITY));
+
+#ifdef CHECK_DURATION
+                           }))
+#endif // CHECK_DURATION
+
+}
+
+// Les multiplicateurs de courte durée partagent le même groupe de threads
+TEST(Multiplier, SharedPool){
+
+#ifdef CHECK_DURATION
+        ASSERT_DURATION_LE(30, ({
+#endif // CHECK_DURATION
+                               constexpr int MATRIXSIZE = 40;
+                               constexpr int NBTHREADS = 4;
+                               constexpr int NBBLOCKSPERROW = 4;
+                               constexpr int NBMULTIPLIERS = 200;
+
+                               std::shared_ptr<WorkerPool> pool = WorkerPool::shared(NBTHREADS);
+                               const int nbThreads = pool->nbThreads();
+
+                               SquareMatrix<int> A(MATRIXSIZE);
+                               SquareMatrix<int> B(MATRIXSIZE);
+                               SquareMatrix<int> C(MATRIXSIZE);
+                               for (int i = 0; i < NBMULTIPLIERS; i++) {
+                                   ThreadedMultiplierType multiplier(NBTHREADS, NBBLOCKSPERROW);
+                                   multiplier.multiply(A, B, &C);
+                               }
+
+                               EXPECT_EQ(pool, WorkerPool::shared());
+                               EXPECT_EQ(nbThreads, pool->nbThreads());
+
+#ifdef CHECK_DURATION
+                           }))
+#endif // CHECK_DURATION
+
+}
+
 
 int main(int argc, char** argv)
 {
     testing::InitGoogleTest(&argc, argv);
 
-    return RUN_ALL_TESTS();
+    int result = RUN_ALL_TESTS();
+
+#ifdef WORKERPOOL_PROFILING
+    JobProfiler::printCounters(std::cout);
+    JobProfiler::dumpChromeTrace("labo6_tests_trace.json");
+#endif // WORKERPOOL_PROFILING
+
+    return result;
 }
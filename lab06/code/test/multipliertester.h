@@ -10,6 +10,7 @@ Description: Ajout d'une fonction permettant de limiter les valeurs
 
 #include <chrono>
 #include <iostream>
+#include <memory>
 
 #include "matrix.h"
 #include "simplematrixmultiplier.h"
@@ -31,8 +32,8 @@ public:
     /**
      * Fonction de test déjà présente, n'a pas de limite de valeur maximale
      */
-    void test(int matrixSize, int nbThreads, int nbBlocksPerRow) {
-        return test_values_limited(matrixSize, nbThreads, nbBlocksPerRow, RAND_MAX);
+    void test(int matrixSize, int nbThreads, int nbBlocksPerRow, std::shared_ptr<WorkerPool> pool = nullptr) {
+        return test_values_limited(matrixSize, nbThreads, nbBlocksPerRow, RAND_MAX, pool);
     }
 
     /**
@@ -43,15 +44,19 @@ public:
      * @param nbThreads
      * @param nbBlocksPerRow
      * @param maxValue : valeur maximale des valeurs générées dans la matrice
+     * @param pool : groupe de threads à utiliser, le groupe partagé s'il est nul
      */
-    void test_values_limited(int matrixSize, int nbThreads, int nbBlocksPerRow, int maxValue)
+    void test_values_limited(int matrixSize, int nbThreads, int nbBlocksPerRow, int maxValue,
+                             std::shared_ptr<WorkerPool> pool = nullptr)
     {
         using T = decltype(ThreadedMultiplierType::getElementType());
+        using Accumulator = decltype(ThreadedMultiplierType::getAccumulatorType());
+        using Traits = typename ThreadedMultiplierType::AccumulationTraits;
 
         SquareMatrix<T> A(matrixSize);
         SquareMatrix<T> B(matrixSize);
-        SquareMatrix<T> C(matrixSize);
-        SquareMatrix<T> C_ref(matrixSize);
+        SquareMatrix<Accumulator> C(matrixSize);
+        SquareMatrix<Accumulator> C_ref(matrixSize);
 
         for (int i = 0; i < matrixSize; i++) {
             for (int j = 0; j < matrixSize; j++) {
@@ -62,13 +67,14 @@ public:
             }
         }
 
-        SimpleMatrixMultiplier<T> multiplier;
+        SimpleMatrixMultiplier<T, Traits> multiplier;
         auto start = std::chrono::steady_clock::now();
         multiplier.multiply(A, B, &C_ref);
         auto end = std::chrono::steady_clock::now();
         int64_t timeSimple = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 
-        ThreadedMultiplierType threadedMultiplier(nbThreads, nbBlocksPerRow);
+        ThreadedMultiplierType threadedMultiplier = pool ? ThreadedMultiplierType(pool, nbBlocksPerRow)
+                                                         : ThreadedMultiplierType(nbThreads, nbBlocksPerRow);
         start = std::chrono::steady_clock::now();
         threadedMultiplier.multiply(A, B, &C);
         end = std::chrono::steady_clock::now();
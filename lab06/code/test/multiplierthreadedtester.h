@@ -15,11 +15,13 @@ template<class ThreadedMultiplierType>
 void test_int(int matrixSize, int nbBlocksPerRow, ThreadedMultiplierType* threadedMultiplier)
 {
     using T = decltype(ThreadedMultiplierType::getElementType());
+    using Accumulator = decltype(ThreadedMultiplierType::getAccumulatorType());
+    using Traits = typename ThreadedMultiplierType::AccumulationTraits;
 
     SquareMatrix<T> A(matrixSize);
     SquareMatrix<T> B(matrixSize);
-    SquareMatrix<T> C(matrixSize);
-    SquareMatrix<T> C_ref(matrixSize);
+    SquareMatrix<Accumulator> C(matrixSize);
+    SquareMatrix<Accumulator> C_ref(matrixSize);
 
     for (int i = 0; i < matrixSize; i++) {
         for (int j = 0; j < matrixSize; j++) {
@@ -30,7 +32,7 @@ void test_int(int matrixSize, int nbBlocksPerRow, ThreadedMultiplierType* thread
         }
     }
 
-    SimpleMatrixMultiplier<T> multiplier;
+    SimpleMatrixMultiplier<T, Traits> multiplier;
     auto start = std::chrono::steady_clock::now();
     multiplier.multiply(A, B, &C_ref);
     auto end = std::chrono::steady_clock::now();
@@ -0,0 +1,96 @@
+#ifndef SPARSEMULTIPLIERTESTER_H
+#define SPARSEMULTIPLIERTESTER_H
+
+/*
+Auteurs: Alexandre Jaquier, Valentin Kaelin
+Date: 19.10.2026
+Description: Test des multiplicateurs de matrices creuses par comparaison
+             avec la multiplication dense de référence
+*/
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+#include "matrix.h"
+#include "simplematrixmultiplier.h"
+#include "sparsematrix.h"
+#include "threadedsparsematrixmultiplier.h"
+
+
+/**
+ * This class implements a tester for the sparse multiplier. It computes the
+ * product of two mostly empty matrices with the dense simple multiplier and
+ * with the sparse one (SpMM and SpGEMM), compares the results and the time
+ * spent by both implementations.
+ */
+template<class SparseMultiplierType>
+class SparseMultiplierTester
+{
+public:
+    SparseMultiplierTester() {}
+
+    /**
+     * @param matrixSize
+     * @param nbThreads
+     * @param nbBlocks
+     * @param density : proportion d'éléments non nuls dans A et B
+     * @param pool : groupe de threads à utiliser, le groupe partagé s'il est nul
+     * @return vrai si les deux produits creux sont identiques au produit dense
+     */
+    bool test(int matrixSize, int nbThreads, int nbBlocks, double density,
+              std::shared_ptr<WorkerPool> pool = nullptr)
+    {
+        using T = decltype(SparseMultiplierType::getElementType());
+        using Accumulator = decltype(SparseMultiplierType::getAccumulatorType());
+        using Traits = typename SparseMultiplierType::AccumulationTraits;
+
+        SquareMatrix<T> A(matrixSize);
+        SquareMatrix<T> B(matrixSize);
+        SquareMatrix<Accumulator> C(matrixSize);
+        SquareMatrix<Accumulator> C_sparse(matrixSize);
+        SquareMatrix<Accumulator> C_ref(matrixSize);
+
+        const int threshold = static_cast<int>(density * RAND_MAX);
+        for (int i = 0; i < matrixSize; i++) {
+            for (int j = 0; j < matrixSize; j++) {
+                A.setElement(i, j, rand() < threshold ? 1 + rand() % 100 : 0);
+                B.setElement(i, j, rand() < threshold ? 1 + rand() % 100 : 0);
+                C.setElement(i, j, 0);
+                C_ref.setElement(i, j, 0);
+            }
+        }
+
+        CsrMatrix<T> A_csr = CsrMatrix<T>::fromDense(A);
+        CsrMatrix<T> B_csr = CsrMatrix<T>::fromDense(B);
+
+        SimpleMatrixMultiplier<T, Traits> multiplier;
+        auto start = std::chrono::steady_clock::now();
+        multiplier.multiply(A, B, &C_ref);
+        auto end = std::chrono::steady_clock::now();
+        int64_t timeDense = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+        SparseMultiplierType sparseMultiplier = pool ? SparseMultiplierType(pool, nbBlocks)
+                                                     : SparseMultiplierType(nbThreads, nbBlocks);
+        start = std::chrono::steady_clock::now();
+        sparseMultiplier.multiply(A_csr, B, &C);
+        end = std::chrono::steady_clock::now();
+        int64_t timeSpMM = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+        CsrMatrix<Accumulator> C_csr(matrixSize, matrixSize);
+        start = std::chrono::steady_clock::now();
+        sparseMultiplier.multiply(A_csr, B_csr, &C_csr);
+        end = std::chrono::steady_clock::now();
+        int64_t timeSpGEMM = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        C_csr.toDense(&C_sparse);
+
+        bool ok = C.compare(C_ref);
+        ok = C_sparse.compare(C_ref) && ok;
+
+        std::cout << "Dense: " << timeDense << " ms / SpMM: " << timeSpMM
+                  << " ms / SpGEMM: " << timeSpGEMM << " ms" << std::endl;
+        return ok;
+    }
+};
+
+#endif // SPARSEMULTIPLIERTESTER_H